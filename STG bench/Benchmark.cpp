@@ -0,0 +1,307 @@
+﻿// 模拟核心热点循环的基准测试：不依赖 SDL，可以在没有显示器的 Linux 上运行
+#include "AllocationCounter.h"
+#include "Collide.h"
+#include "Integrate.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int BULLET_COUNTS[] = { 100, 1000, 10000, 100000 };
+const int ENEMY_COUNTS[] = { 10, 100, 1000, 5000 };
+const int MIN_SAMPLES = 5;
+const int MAX_SAMPLES = 100000;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+    const char* filter; // 只运行名称包含该字符串的测试
+    double minSeconds;  // 每组参数至少运行的时间
+    bool failOnAlloc;   // 计时部分有堆分配时以失败退出
+};
+
+struct Measurement {
+    double ns;          // 每次 body 耗时的中位数（纳秒）
+    double allocations; // 每次 body 的平均堆分配次数
+};
+
+int allocatingRows = 0; // 计时部分有堆分配的测试行数
+
+// 合成场景：子弹和敌人随机分布在屏幕内，玩家子弹和敌人子弹各占一半，玩家位于屏幕中央且不会死亡
+// margin 为子弹离屏幕上下边缘的最小距离，offscreen 为放在屏幕外的子弹比例
+void populate(Simulation& sim, int bulletCount, int enemyCount, int margin, double offscreen) {
+    Rng rng;
+    rng.seed(bulletCount * 7919ULL + enemyCount, 0);
+
+    sim.reset(1);
+    Fixed playerX = toFixed(SCREEN_WIDTH / 2 - 25);
+    Fixed playerY = toFixed(SCREEN_HEIGHT / 2 - 25);
+    sim.player.transform = Transform{ playerX, playerY, playerX, playerY };
+    sim.player.hitbox = Hitbox{ 50, 50 };
+    sim.player.lives = 1 << 30;
+
+    sim.playerBullets = BulletPool((std::max)(bulletCount, MAX_BULLETS));
+    sim.enemyBullets = BulletPool((std::max)(bulletCount, MAX_BULLETS));
+    uint32_t offscreenLimit = static_cast<uint32_t>(offscreen * 1000.0);
+    for (int i = 0; i < bulletCount; ++i) {
+        int x = rng.range(0, SCREEN_WIDTH - BulletPool::BULLET_W);
+        int y = rng.range(margin, SCREEN_HEIGHT - margin);
+        if (rng.below(1000) < offscreenLimit) {
+            y = (i & 1) ? -BulletPool::BULLET_H : SCREEN_HEIGHT + 1;
+        }
+        BulletPool& pool = (i & 1) ? sim.enemyBullets : sim.playerBullets;
+        int speedY = rng.range(-10, 11);
+        int speedX = rng.range(-3, 4);
+        pool.spawn(toFixed(x), toFixed(y), toFixed(speedX), toFixed(speedY));
+    }
+
+    // 少量敌人放在底部附近，让到达底部的检测有命中
+    sim.enemies.clear();
+    for (int i = 0; i < enemyCount; ++i) {
+        int x = rng.range(0, SCREEN_WIDTH - 50);
+        int y = rng.range(0, SCREEN_HEIGHT - 40);
+        sim.createEnemy(x, y, 0, 1000 + rng.below(2000));
+    }
+}
+
+// 反复执行 setup（不计时）和 ops 次 body（计时），返回每次 body 耗时的中位数和平均堆分配次数
+// 先预热一次，让容器增长到稳定容量，预热中的分配不计入
+template <typename Setup, typename Body>
+Measurement measure(const Options& options, int ops, Setup setup, Body body) {
+    FrameArena::current().reset();
+    setup();
+    for (int i = 0; i < ops; ++i) {
+        body();
+    }
+
+    std::vector<double> samples;
+    double total = 0.0;
+    uint64_t allocations = 0;
+    while ((total < options.minSeconds || samples.size() < MIN_SAMPLES) && samples.size() < MAX_SAMPLES) {
+        FrameArena::current().reset(); // 每次采样相当于一个逻辑帧，回收上一次的临时数据
+        setup();
+        AllocationCount before = threadAllocations();
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < ops; ++i) {
+            body();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocations += (threadAllocations() - before).count;
+        samples.push_back(seconds * 1e9 / ops);
+        total += seconds;
+    }
+    size_t sampleCount = samples.size();
+    std::nth_element(samples.begin(), samples.begin() + sampleCount / 2, samples.end());
+    return Measurement{ samples[sampleCount / 2], static_cast<double>(allocations) / (sampleCount * ops) };
+}
+
+void report(const char* name, int bullets, int enemies, const Measurement& result, int entities) {
+    double nsPerEntity = result.ns / (std::max)(entities, 1);
+    std::printf("%-28s %8d %8d %12.1f %10.2f %12.1f %9.2f\n", name, bullets, enemies, result.ns, nsPerEntity, 1000.0 / nsPerEntity, result.allocations);
+    if (result.allocations > 0.0) {
+        allocatingRows++;
+    }
+}
+
+bool selected(const Options& options, const char* name) {
+    return options.filter == nullptr || std::strstr(name, options.filter) != nullptr;
+}
+
+// 玩家子弹的融合遍历：移动、出屏剔除并通过网格检测敌人
+void benchUpdatePlayerBullets(const Options& options) {
+    for (int bullets : BULLET_COUNTS) {
+        for (int enemies : ENEMY_COUNTS) {
+            Simulation base;
+            populate(base, bullets, enemies, 0, 0.0);
+            Simulation sim(base);
+            Measurement result = measure(options, 1,
+                [&]() { sim.playerBullets = base.playerBullets; sim.enemies = base.enemies; },
+                [&]() { sim.updatePlayerBullets(sim.playerBullets.count); });
+            report("updatePlayerBullets", bullets, enemies, result, base.playerBullets.count);
+        }
+    }
+}
+
+// 敌人子弹的融合遍历：移动、出屏剔除并检测玩家
+void benchUpdateEnemyBullets(const Options& options) {
+    for (int bullets : BULLET_COUNTS) {
+        Simulation base;
+        populate(base, bullets, 0, 0, 0.0);
+        Simulation sim(base);
+        Measurement result = measure(options, 1,
+            [&]() { sim.enemyBullets = base.enemyBullets; },
+            [&]() { sim.updateEnemyBullets(sim.enemyBullets.count); });
+        report("updateEnemyBullets", bullets, 0, result, base.enemyBullets.count);
+    }
+}
+
+// 批量 AABB 检测：敌人子弹与玩家矩形比较，分别测试各个 SIMD 实现
+void benchAabbBatch(const Options& options) {
+    const AabbBatchFunction kernels[] = { aabbBatchScalar, aabbBatchSse2, aabbBatchAvx2 };
+    const char* names[] = { "aabbBatch scalar", "aabbBatch SSE2", "aabbBatch AVX2" };
+    for (int bullets : { 1000, 10000, 50000, 100000 }) {
+        Simulation base;
+        populate(base, bullets * 2, 0, 0, 0.0);
+        const BulletPool& pool = base.enemyBullets;
+        std::vector<uint32_t> mask((pool.count + 31) / 32);
+        for (int k = 0; k < 3; ++k) {
+            if (kernels[k] == nullptr) {
+                continue;
+            }
+            Measurement result = measure(options, 16,
+                []() {},
+                [&]() { kernels[k](pool.x.data(), pool.y.data(), pool.count, BulletPool::BULLET_W, BulletPool::BULLET_H, base.playerRect(), mask.data()); });
+            report(names[k], pool.count, 0, result, pool.count);
+        }
+    }
+}
+
+// 子弹移动和出屏标记：速度带小数部分和加速度，分别测试各个 SIMD 实现
+void benchIntegrate(const Options& options) {
+    const IntegrateFunction kernels[] = { integrateBulletsScalar, integrateBulletsSse2, integrateBulletsAvx2 };
+    const char* names[] = { "integrate scalar", "integrate SSE2", "integrate AVX2" };
+    for (int bullets : { 1000, 10000, 50000, 100000 }) {
+        Rng rng;
+        rng.seed(bullets, 0);
+        BulletPool base(bullets);
+        for (int i = 0; i < bullets; ++i) {
+            base.spawn(rng.range(0, toFixed(SCREEN_WIDTH)), rng.range(0, toFixed(SCREEN_HEIGHT)),
+                rng.range(-3 * FIXED_ONE, 3 * FIXED_ONE), rng.range(-10 * FIXED_ONE, 10 * FIXED_ONE),
+                rng.range(-FIXED_ONE / 16, FIXED_ONE / 16), rng.range(-FIXED_ONE / 16, FIXED_ONE / 16));
+        }
+        BulletPool pool(base);
+        for (int k = 0; k < 3; ++k) {
+            if (kernels[k] == nullptr) {
+                continue;
+            }
+            BulletStreams streams = { pool.x.data(), pool.y.data(), pool.prevX.data(), pool.prevY.data(), pool.speedX.data(), pool.speedY.data(),
+                pool.accelX.data(), pool.accelY.data(), pool.dead.data() };
+            Measurement result = measure(options, 1,
+                [&]() { pool = base; },
+                [&]() { kernels[k](streams, 0, pool.count, 0, toFixed(SCREEN_HEIGHT)); });
+            report(names[k], pool.count, 0, result, pool.count);
+        }
+    }
+}
+
+// 结算命中事件，只计 resolveHits() 的时间
+void benchResolveHits(const Options& options) {
+    for (int bullets : BULLET_COUNTS) {
+        for (int enemies : ENEMY_COUNTS) {
+            Simulation base;
+            populate(base, bullets, enemies, 0, 0.0);
+            Simulation sim(base);
+            Measurement result = measure(options, 1,
+                [&]() {
+                    sim.playerBullets = base.playerBullets;
+                    sim.enemyBullets = base.enemyBullets;
+                    sim.enemies = base.enemies;
+                    sim.updatePlayerBullets(sim.playerBullets.count);
+                    sim.updateEnemyBullets(sim.enemyBullets.count);
+                },
+                [&]() { sim.resolveHits(); });
+            report("resolveHits", bullets, enemies, result, bullets);
+        }
+    }
+}
+
+// 出屏剔除：四分之一的子弹在屏幕外，只计 compact() 的时间
+void benchCull(const Options& options) {
+    for (int bullets : BULLET_COUNTS) {
+        Simulation base;
+        populate(base, bullets, 0, 20, 0.25);
+        Simulation sim(base);
+        Measurement result = measure(options, 1,
+            [&]() { sim.enemyBullets = base.enemyBullets; sim.updateEnemyBullets(sim.enemyBullets.count); },
+            [&]() { sim.enemyBullets.compact(); });
+        report("cull", bullets, 0, result, base.enemyBullets.count);
+    }
+}
+
+void benchPlayerEnemy(const Options& options) {
+    for (int enemies : ENEMY_COUNTS) {
+        Simulation base;
+        populate(base, 0, enemies, 0, 0.0);
+        Simulation sim(base);
+        Measurement result = measure(options, 1,
+            [&]() { sim.enemies = base.enemies; },
+            [&]() { sim.checkPlayerEnemyCollision(); });
+        report("checkPlayerEnemyCollision", 0, enemies, result, enemies);
+    }
+}
+
+void benchEnemyBottom(const Options& options) {
+    for (int enemies : ENEMY_COUNTS) {
+        Simulation base;
+        populate(base, 0, enemies, 0, 0.0);
+        Simulation sim(base);
+        Measurement result = measure(options, 1,
+            [&]() { sim.enemies = base.enemies; },
+            [&]() { sim.checkEnemyBottomCollision(); });
+        report("checkEnemyBottomCollision", 0, enemies, result, enemies);
+    }
+}
+
+// 生成敌人：每次调用都满足生成间隔，在已有 enemies 个敌人的基础上连续生成 64 个
+void benchSpawnEnemy(const Options& options) {
+    const int spawns = 64;
+    for (int enemies : ENEMY_COUNTS) {
+        Simulation base;
+        populate(base, 0, enemies, 0, 0.0);
+        base.clock = 1000.0;
+        Simulation sim(base);
+        Measurement result = measure(options, spawns,
+            [&]() { sim.enemies = base.enemies; },
+            [&]() { sim.lastEnemySpawnTime = 0; sim.spawnEnemy(); });
+        report("spawnEnemy", 0, enemies, result, 1);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    // 命令行参数：[--filter 名称] [--time 毫秒] [--fail-on-alloc]
+    Options options = { nullptr, 0.2, false };
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            options.minSeconds = std::atof(argv[++i]) / 1000.0;
+        }
+        else if (std::strcmp(argv[i], "--fail-on-alloc") == 0) {
+            options.failOnAlloc = true;
+        }
+    }
+#if !STG_ALLOC_TRACKING
+    // 没有计数时无法判断是否分配，拒绝运行而不是让检查总是通过
+    if (options.failOnAlloc) {
+        std::printf("--fail-on-alloc needs heap allocation tracking; build with STG_ALLOC_TRACKING=1\n");
+        return 1;
+    }
+#endif
+
+    std::printf("AABB kernel: %s, integrate kernel: %s\n", aabbBatchName(), integrateBulletsName());
+    std::printf("%-28s %8s %8s %12s %10s %12s %9s\n", "Benchmark", "Bullets", "Enemies", "ns/op", "ns/entity", "M entities/s", "allocs/op");
+    if (selected(options, "updatePlayerBullets")) benchUpdatePlayerBullets(options);
+    if (selected(options, "updateEnemyBullets")) benchUpdateEnemyBullets(options);
+    if (selected(options, "aabbBatch")) benchAabbBatch(options);
+    if (selected(options, "integrate")) benchIntegrate(options);
+    if (selected(options, "resolveHits")) benchResolveHits(options);
+    if (selected(options, "cull")) benchCull(options);
+    if (selected(options, "checkPlayerEnemyCollision")) benchPlayerEnemy(options);
+    if (selected(options, "checkEnemyBottomCollision")) benchEnemyBottom(options);
+    if (selected(options, "spawnEnemy")) benchSpawnEnemy(options);
+
+    if (options.failOnAlloc && allocatingRows > 0) {
+        std::printf("FAILED: %d benchmark rows allocated on the heap\n", allocatingRows);
+        return 1;
+    }
+    return 0;
+}
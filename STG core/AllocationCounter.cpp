@@ -0,0 +1,164 @@
+﻿#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+#if defined(__cpp_aligned_new) && !defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace {
+
+// 平凡类型的线程局部变量没有动态初始化，可以在 operator new 中安全使用
+thread_local AllocationCount counter = { 0, 0 };
+
+}
+
+AllocationCount threadAllocations() {
+    return counter;
+}
+
+void recordAllocation(size_t bytes) {
+#if STG_ALLOC_TRACKING
+    counter.count++;
+    counter.bytes += bytes;
+#else
+    (void)bytes;
+#endif
+}
+
+#if STG_ALLOC_TRACKING
+
+// 替换全局 operator new / delete，所有 C++ 堆分配都经过计数
+namespace {
+
+void* countedNew(size_t size) {
+    recordAllocation(size);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* countedNewNothrow(size_t size) noexcept {
+    recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+#ifdef __cpp_aligned_new
+
+// 超过默认对齐的类型（C++17 起）走带 std::align_val_t 的重载，同样计数
+void* alignedMalloc(size_t size, size_t alignment) noexcept {
+    recordAllocation(size);
+#ifdef _MSC_VER
+    return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, alignment, size == 0 ? 1 : size) == 0 ? p : nullptr;
+#endif
+}
+
+void alignedFree(void* p) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* countedAlignedNew(size_t size, std::align_val_t alignment) {
+    void* p = alignedMalloc(size, static_cast<size_t>(alignment));
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+#endif
+
+}
+
+void* operator new(size_t size) {
+    return countedNew(size);
+}
+
+void* operator new[](size_t size) {
+    return countedNew(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedNewNothrow(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedNewNothrow(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+#ifdef __cpp_aligned_new
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return countedAlignedNew(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return countedAlignedNew(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return alignedMalloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return alignedMalloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    alignedFree(p);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 堆分配计数：替换全局 operator new，统计每个线程的分配次数和字节数
+// 调试版或定义了 STG_PROFILING=1 时默认开启，发布版默认不替换 operator new
+// 也可以在工程中定义 STG_ALLOC_TRACKING=1 或 0 强制开关（需要同时对 STG core 定义）
+#ifndef STG_ALLOC_TRACKING
+#if defined(_DEBUG) || (defined(STG_PROFILING) && STG_PROFILING)
+#define STG_ALLOC_TRACKING 1
+#else
+#define STG_ALLOC_TRACKING 0
+#endif
+#endif
+
+struct AllocationCount {
+    uint64_t count;
+    uint64_t bytes;
+
+    AllocationCount operator-(const AllocationCount& other) const {
+        return AllocationCount{ count - other.count, bytes - other.bytes };
+    }
+};
+
+// 当前线程累计的分配（只增不减），在两个时刻读取并相减得到这段时间内的分配
+// 关闭计数时始终为 0
+AllocationCount threadAllocations();
+
+// 不经过 operator new 的分配（malloc、SDL 的内存函数）由调用方报告
+void recordAllocation(size_t bytes);
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include "SimTypes.h"
+#include "Integrate.h"
+#include <vector>
+
+// 子弹池：按结构体数组(SoA)存放同一阵营的子弹，容量在构造时一次性分配
+// 位置、速度（每逻辑帧）和加速度均为 16.16 定点数，只在碰撞和绘制时转换为像素
+class BulletPool {
+public:
+    static const int BULLET_W = 5;
+    static const int BULLET_H = 10;
+
+    std::vector<Fixed> x;
+    std::vector<Fixed> y;
+    std::vector<Fixed> prevX;       // 上一逻辑帧的位置，用于渲染插值
+    std::vector<Fixed> prevY;
+    std::vector<Fixed> speedX;
+    std::vector<Fixed> speedY;
+    std::vector<Fixed> accelX;
+    std::vector<Fixed> accelY;
+    std::vector<uint8_t> dead;      // 本帧被标记移除的子弹
+    int count;
+    int capacity;
+
+    explicit BulletPool(int cap) : count(0), capacity(cap), pendingRemoval(false) {
+        x.resize(cap);
+        y.resize(cap);
+        prevX.resize(cap);
+        prevY.resize(cap);
+        speedX.resize(cap);
+        speedY.resize(cap);
+        accelX.resize(cap);
+        accelY.resize(cap);
+        dead.resize(cap);
+    }
+
+    // 池满时丢弃新子弹，保证运行时不再分配内存
+    bool spawn(Fixed px, Fixed py, Fixed spdX, Fixed spdY, Fixed accX = 0, Fixed accY = 0) {
+        if (count >= capacity) {
+            return false;
+        }
+        x[count] = px;
+        y[count] = py;
+        prevX[count] = px;  // 本帧移动之后生成的子弹停在原地绘制
+        prevY[count] = py;
+        speedX[count] = spdX;
+        speedY[count] = spdY;
+        accelX[count] = accX;
+        accelY[count] = accY;
+        dead[count] = 0;
+        count++;
+        return true;
+    }
+
+    // 移动下标在 [begin, end) 之间的子弹，同时标记移出屏幕上下边缘的子弹
+    void integrate(int begin, int end) {
+        BulletStreams streams = { x.data(), y.data(), prevX.data(), prevY.data(), speedX.data(), speedY.data(), accelX.data(), accelY.data(), dead.data() };
+        if (integrateBullets()(streams, begin, end, CULL_TOP, CULL_BOTTOM)) {
+            pendingRemoval = true;
+        }
+    }
+
+    // 只做标记，真正的移除在 compact() 中统一完成
+    void kill(int i) {
+        dead[i] = 1;
+        pendingRemoval = true;
+    }
+
+    Rect rect(int i) const {
+        return Rect{ toPixels(x[i]), toPixels(y[i]), BULLET_W, BULLET_H };
+    }
+
+    // 一次线性扫描移除所有被标记的子弹，保持剩余子弹的顺序
+    void compact() {
+        if (!pendingRemoval) {
+            return;
+        }
+        int alive = 0;
+        for (int i = 0; i < count; ++i) {
+            if (dead[i]) {
+                continue;
+            }
+            if (alive != i) {
+                x[alive] = x[i];
+                y[alive] = y[i];
+                prevX[alive] = prevX[i];
+                prevY[alive] = prevY[i];
+                speedX[alive] = speedX[i];
+                speedY[alive] = speedY[i];
+                accelX[alive] = accelX[i];
+                accelY[alive] = accelY[i];
+                dead[alive] = 0;
+            }
+            alive++;
+        }
+        count = alive;
+        pendingRemoval = false;
+    }
+
+    void clear() {
+        count = 0;
+        pendingRemoval = false;
+    }
+
+private:
+    // 像素 y 不在 [0, SCREEN_HEIGHT] 内的子弹被移除，换算成定点数范围
+    static const Fixed CULL_TOP = 0;
+    static const Fixed CULL_BOTTOM = (SCREEN_HEIGHT + 1) * FIXED_ONE - 1;
+
+    bool pendingRemoval;
+};
@@ -0,0 +1,143 @@
+﻿#include "Collide.h"
+#include "CpuFeatures.h"
+
+namespace {
+
+// 宽高固定为正数时，intersects() 化简为 lowX < x < highX 且 lowY < y < highY
+struct AabbBounds {
+    int lowX;
+    int highX;
+    int lowY;
+    int highY;
+    bool empty;
+};
+
+AabbBounds boundsOf(int w, int h, const Rect& target) {
+    AabbBounds bounds;
+    // 像素坐标 px > target.x - w 等价于定点数 x >= toFixed(target.x - w + 1)，比较保持严格不等
+    bounds.lowX = toFixed(target.x - w + 1) - 1;
+    bounds.highX = toFixed(target.x + target.w);
+    bounds.lowY = toFixed(target.y - h + 1) - 1;
+    bounds.highY = toFixed(target.y + target.h);
+    bounds.empty = w <= 0 || h <= 0 || target.w <= 0 || target.h <= 0;
+    return bounds;
+}
+
+void clearMask(int count, uint32_t* mask) {
+    for (int i = 0; i < (count + 31) / 32; ++i) {
+        mask[i] = 0;
+    }
+}
+
+void scalarRange(const int* x, const int* y, int begin, int count, const AabbBounds& b, uint32_t* mask) {
+    for (int i = begin; i < count; ++i) {
+        if (x[i] > b.lowX && x[i] < b.highX && y[i] > b.lowY && y[i] < b.highY) {
+            mask[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+#if STG_X86
+
+STG_TARGET_SSE2 void sse2Kernel(const int* x, const int* y, int count, int w, int h, const Rect& target, uint32_t* mask) {
+    clearMask(count, mask);
+    AabbBounds b = boundsOf(w, h, target);
+    if (b.empty) {
+        return;
+    }
+    const __m128i lowX = _mm_set1_epi32(b.lowX);
+    const __m128i highX = _mm_set1_epi32(b.highX);
+    const __m128i lowY = _mm_set1_epi32(b.lowY);
+    const __m128i highY = _mm_set1_epi32(b.highY);
+
+    // 每次处理 8 个矩形，两组 4 位结果拼成一个字节
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t bits = 0;
+        for (int half = 0; half < 2; ++half) {
+            __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + half * 4));
+            __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i + half * 4));
+            __m128i inside = _mm_and_si128(
+                _mm_and_si128(_mm_cmpgt_epi32(vx, lowX), _mm_cmpgt_epi32(highX, vx)),
+                _mm_and_si128(_mm_cmpgt_epi32(vy, lowY), _mm_cmpgt_epi32(highY, vy)));
+            bits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(inside))) << (half * 4);
+        }
+        mask[i >> 5] |= bits << (i & 31);
+    }
+    scalarRange(x, y, i, count, b, mask);
+}
+
+STG_TARGET_AVX2 void avx2Kernel(const int* x, const int* y, int count, int w, int h, const Rect& target, uint32_t* mask) {
+    clearMask(count, mask);
+    AabbBounds b = boundsOf(w, h, target);
+    if (b.empty) {
+        return;
+    }
+    const __m256i lowX = _mm256_set1_epi32(b.lowX);
+    const __m256i highX = _mm256_set1_epi32(b.highX);
+    const __m256i lowY = _mm256_set1_epi32(b.lowY);
+    const __m256i highY = _mm256_set1_epi32(b.highY);
+
+    // 每次处理 8 个矩形，每 4 次拼成一个完整的 32 位掩码
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+        __m256i inside = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(vx, lowX), _mm256_cmpgt_epi32(highX, vx)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(vy, lowY), _mm256_cmpgt_epi32(highY, vy)));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+        mask[i >> 5] |= bits << (i & 31);
+    }
+    scalarRange(x, y, i, count, b, mask);
+}
+
+#endif
+
+struct AabbDispatch {
+    AabbBatchFunction function;
+    const char* name;
+};
+
+AabbDispatch selectKernel() {
+#if STG_X86
+    if (cpuHasAvx2()) {
+        return AabbDispatch{ avx2Kernel, "AVX2" };
+    }
+    if (cpuHasSse2()) {
+        return AabbDispatch{ sse2Kernel, "SSE2" };
+    }
+#endif
+    return AabbDispatch{ aabbBatchScalar, "scalar" };
+}
+
+const AabbDispatch& dispatch() {
+    static const AabbDispatch selected = selectKernel();
+    return selected;
+}
+
+}
+
+void aabbBatchScalar(const int* x, const int* y, int count, int w, int h, const Rect& target, uint32_t* mask) {
+    clearMask(count, mask);
+    AabbBounds b = boundsOf(w, h, target);
+    if (!b.empty) {
+        scalarRange(x, y, 0, count, b, mask);
+    }
+}
+
+#if STG_X86
+const AabbBatchFunction aabbBatchSse2 = cpuHasSse2() ? sse2Kernel : nullptr;
+const AabbBatchFunction aabbBatchAvx2 = cpuHasAvx2() ? avx2Kernel : nullptr;
+#else
+const AabbBatchFunction aabbBatchSse2 = nullptr;
+const AabbBatchFunction aabbBatchAvx2 = nullptr;
+#endif
+
+AabbBatchFunction aabbBatch() {
+    return dispatch().function;
+}
+
+const char* aabbBatchName() {
+    return dispatch().name;
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+#include "SimTypes.h"
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 批量 AABB 检测：count 个宽高为 w x h 的矩形（左上角为定点数，按 SoA 存放在 x、y 中）与像素矩形 target 逐个检测
+// 第 i 个矩形相交时置位 mask[i / 32] 的第 i % 32 位，判定规则与先向下取整到像素再调用 intersects() 相同
+typedef void (*AabbBatchFunction)(const int* x, const int* y, int count, int w, int h, const Rect& target, uint32_t* mask);
+
+// 启动时按 CPU 支持的指令集选一次：AVX2（每条指令 8 个矩形）、SSE2（4 个）或标量
+AabbBatchFunction aabbBatch();
+
+// 当前使用的实现名称，用于基准测试和统计显示
+const char* aabbBatchName();
+
+// 各个实现，基准测试可以直接比较；CPU 不支持时对应指针为空
+void aabbBatchScalar(const int* x, const int* y, int count, int w, int h, const Rect& target, uint32_t* mask);
+extern const AabbBatchFunction aabbBatchSse2;
+extern const AabbBatchFunction aabbBatchAvx2;
+
+// 最低的置位位的序号，bits 不能为 0
+inline int lowestBit(uint32_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
@@ -0,0 +1,42 @@
+﻿#include "CpuFeatures.h"
+
+#if STG_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+bool cpuHasSse2() {
+#if !STG_X86
+    return false;
+#elif defined(_M_X64) || defined(__x86_64__)
+    return true; // x64 一定支持 SSE2
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+// AVX2 需要 CPU 支持，同时操作系统要保存 YMM 寄存器
+bool cpuHasAvx2() {
+#if !STG_X86
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
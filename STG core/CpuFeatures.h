@@ -0,0 +1,21 @@
+﻿#pragma once
+
+// SIMD 内核共用的 x86 检测：STG_X86 为 1 时可以使用 SSE2 / AVX2 内建函数
+// GCC 和 Clang 需要给使用高级指令集的函数标上 target 属性，MSVC 不需要
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STG_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define STG_TARGET_SSE2
+#define STG_TARGET_AVX2
+#else
+#define STG_TARGET_SSE2 __attribute__((target("sse2")))
+#define STG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define STG_X86 0
+#endif
+
+// 运行时检测 CPU 和操作系统是否支持对应指令集，非 x86 平台始终返回 false
+bool cpuHasSse2();
+bool cpuHasAvx2();
@@ -0,0 +1,65 @@
+﻿#include "FrameArena.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+FrameArena::FrameArena(size_t size)
+    : blockSize(size),
+    blockIndex(0),
+    offset(0),
+    usedBytes(0),
+    peakBytes(0),
+    systemAllocationCount(0) {}
+
+FrameArena::~FrameArena() {
+    for (const auto& block : blocks) {
+        std::free(block.data);
+    }
+}
+
+FrameArena& FrameArena::current() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    // 从当前块开始找第一个放得下的块，都放不下时向系统申请新块
+    for (; blockIndex < blocks.size(); ++blockIndex, offset = 0) {
+        Block& block = blocks[blockIndex];
+        uintptr_t address = reinterpret_cast<uintptr_t>(block.data) + offset;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (offset + padding + bytes <= block.size) {
+            offset += padding + bytes;
+            usedBytes += padding + bytes;
+            peakBytes = (std::max)(peakBytes, usedBytes);
+            return block.data + offset - bytes;
+        }
+    }
+
+    size_t size = (std::max)(blockSize, bytes + alignment);
+    char* data = static_cast<char*>(std::malloc(size));
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    recordAllocation(size);
+    systemAllocationCount++;
+    blocks.push_back(Block{ data, size });
+    blockIndex = blocks.size() - 1;
+    offset = 0;
+    return allocate(bytes, alignment);
+}
+
+void FrameArena::reset() {
+    blockIndex = 0;
+    offset = 0;
+    usedBytes = 0;
+}
+
+size_t FrameArena::reserved() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
@@ -0,0 +1,123 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// 以 C++17 编译时另外提供 std::pmr 适配器
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+#define STG_HAS_PMR 1
+#include <memory_resource>
+#else
+#define STG_HAS_PMR 0
+#endif
+
+// 逐帧线性分配器：分配只移动指针，释放什么也不做，每个逻辑帧结束时 reset() 一次性回收本帧的全部分配
+// 内存按块向系统申请，reset() 后块保留下来重复使用，预热后的稳态帧不再向系统申请内存
+class FrameArena {
+public:
+    static const size_t BLOCK_SIZE = 256 * 1024;
+
+    explicit FrameArena(size_t blockSize = BLOCK_SIZE);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 当前线程的逐帧分配器，模拟核心的临时数据都从这里分配，由推进逻辑帧的一方在每帧结束时 reset()
+    static FrameArena& current();
+
+    void* allocate(size_t bytes, size_t alignment);
+
+    // 回收本帧的全部分配，之前分配的内存不能再使用
+    void reset();
+
+    size_t used() const {
+        return usedBytes;
+    }
+
+    // 单帧分配量的最大值
+    size_t peak() const {
+        return peakBytes;
+    }
+
+    // 已向系统申请的内存总量
+    size_t reserved() const;
+
+    // 累计向系统申请内存块的次数，稳态时不再增加
+    uint64_t systemAllocations() const {
+        return systemAllocationCount;
+    }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t blockIndex;  // 正在分配的块
+    size_t offset;      // 在该块中已分配的字节数
+    size_t usedBytes;
+    size_t peakBytes;
+    uint64_t systemAllocationCount;
+};
+
+// 标准库容器使用 FrameArena 的分配器适配器（C++11 分配器模型，C++14 下可用）
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    FrameArena* arena;
+
+    ArenaAllocator(FrameArena& frameArena) : arena(&frameArena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // 内存在 reset() 时统一回收
+    void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+// 只在本帧内有效的数组：每帧重新创建，帧末随 FrameArena 一起回收
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#if STG_HAS_PMR
+// std::pmr 容器使用 FrameArena 的适配器
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(FrameArena& frameArena) : arena(frameArena) {}
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return arena.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    FrameArena& arena;
+};
+#endif
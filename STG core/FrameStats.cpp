@@ -0,0 +1,28 @@
+﻿#include "FrameStats.h"
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+void writePhase(FILE* file, const char* name, const LogHistogram& histogram) {
+    std::fprintf(file, "  %-8s p50 %8.3fms  p95 %8.3fms  p99 %8.3fms  max %8.3fms\n", name,
+        histogram.percentile(50.0) / 1000.0, histogram.percentile(95.0) / 1000.0,
+        histogram.percentile(99.0) / 1000.0, histogram.max() / 1000.0);
+}
+
+}
+
+bool FrameStats::append(const std::string& path, const std::string& title) const {
+    FILE* file = std::fopen(path.c_str(), "a");
+    if (file == nullptr) {
+        std::cerr << "Unable to write frame stats " << path << "!" << std::endl;
+        return false;
+    }
+    std::fprintf(file, "%s, frames %llu\n", title.c_str(), static_cast<unsigned long long>(update.count()));
+    writePhase(file, "update", update);
+    writePhase(file, "render", render);
+    writePhase(file, "present", present);
+    bool written = std::ferror(file) == 0;
+    std::fclose(file);
+    return written;
+}
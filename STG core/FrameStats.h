@@ -0,0 +1,20 @@
+﻿#pragma once
+#include "Histogram.h"
+#include <string>
+
+// 一局游戏的帧时间统计：更新、渲染、提交三个阶段分别记录，单位为微秒
+class FrameStats {
+public:
+    LogHistogram update;
+    LogHistogram render;
+    LogHistogram present;
+
+    void clear() {
+        update.clear();
+        render.clear();
+        present.clear();
+    }
+
+    // 把各阶段的 p50/p95/p99/max 追加到统计文件，title 为这一局的说明
+    bool append(const std::string& path, const std::string& title) const;
+};
@@ -0,0 +1,90 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+// 对数分桶直方图（HDR 风格）：每个 2 的幂区间再均分为 SUB_BUCKETS 个桶
+// 相对误差不超过 1/SUB_BUCKETS，记录是 O(1) 的，内存大小固定，可以记录整局的所有样本
+class LogHistogram {
+public:
+    static const int SUB_BITS = 5;
+    static const uint64_t SUB_BUCKETS = 1ULL << SUB_BITS;
+    static const int MAX_BITS = 36;  // 超过 2^36 的值按最大值记录
+    static const int BUCKET_COUNT = static_cast<int>((MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS);
+
+    LogHistogram() : counts(BUCKET_COUNT, 0), total(0), maxValue(0) {}
+
+    void clear() {
+        counts.assign(BUCKET_COUNT, 0);
+        total = 0;
+        maxValue = 0;
+    }
+
+    void record(uint64_t value) {
+        if (value >= (1ULL << MAX_BITS)) {
+            value = (1ULL << MAX_BITS) - 1;
+        }
+        counts[bucketOf(value)]++;
+        total++;
+        if (value > maxValue) {
+            maxValue = value;
+        }
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    uint64_t max() const {
+        return maxValue;
+    }
+
+    // 第 p 百分位（0 到 100）所在桶的上界，不超过记录过的最大值
+    uint64_t percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > total) rank = total;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t upper = lowerBound(i + 1) - 1;
+                return upper < maxValue ? upper : maxValue;
+            }
+        }
+        return maxValue;
+    }
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t maxValue;
+
+    static int highestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+
+    // 小于 2 * SUB_BUCKETS 的值每个值一个桶，更大的值保留最高的 SUB_BITS + 1 位
+    static int bucketOf(uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) {
+            return static_cast<int>(value);
+        }
+        int shift = highestBit(value) - SUB_BITS;
+        return static_cast<int>((shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+    }
+
+    // 第 index 个桶的最小值
+    static uint64_t lowerBound(int index) {
+        if (index < static_cast<int>(2 * SUB_BUCKETS)) {
+            return static_cast<uint64_t>(index);
+        }
+        int shift = index / static_cast<int>(SUB_BUCKETS) - 1;
+        return (index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    }
+};
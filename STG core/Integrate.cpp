@@ -0,0 +1,136 @@
+﻿#include "Integrate.h"
+#include "CpuFeatures.h"
+
+namespace {
+
+bool scalarRange(const BulletStreams& b, int begin, int end, int top, int bottom) {
+    bool culled = false;
+    for (int i = begin; i < end; ++i) {
+        b.speedX[i] += b.accelX[i];
+        b.speedY[i] += b.accelY[i];
+        b.prevX[i] = b.x[i];
+        b.prevY[i] = b.y[i];
+        b.x[i] += b.speedX[i];
+        int y = b.y[i] += b.speedY[i];
+        if (y < top || y > bottom) {
+            b.dead[i] = 1;
+            culled = true;
+        }
+    }
+    return culled;
+}
+
+#if STG_X86
+
+// 8 个 32 位比较结果（全 1 或全 0）压缩成 8 个 0 / 1 字节并入 dead
+STG_TARGET_SSE2 void storeDead(uint8_t* dead, __m128i low, __m128i high) {
+    __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(low, high), _mm_setzero_si128());
+    bytes = _mm_and_si128(bytes, _mm_set1_epi8(1));
+    __m128i old = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(dead));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dead), _mm_or_si128(old, bytes));
+}
+
+STG_TARGET_SSE2 __m128i sse2Axis(int* position, int* previous, int* speed, const int* accel) {
+    __m128i v = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(speed)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(accel)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(speed), v);
+    __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(previous), old);
+    __m128i p = _mm_add_epi32(old, v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(position), p);
+    return p;
+}
+
+STG_TARGET_SSE2 bool sse2Kernel(const BulletStreams& b, int begin, int end, int top, int bottom) {
+    const __m128i topLimit = _mm_set1_epi32(top);
+    const __m128i bottomLimit = _mm_set1_epi32(bottom);
+    __m128i culled = _mm_setzero_si128();
+
+    // 每次处理 8 颗子弹，出屏结果正好拼成 8 个 dead 字节
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m128i out[2];
+        for (int half = 0; half < 2; ++half) {
+            int j = i + half * 4;
+            sse2Axis(b.x + j, b.prevX + j, b.speedX + j, b.accelX + j);
+            __m128i y = sse2Axis(b.y + j, b.prevY + j, b.speedY + j, b.accelY + j);
+            out[half] = _mm_or_si128(_mm_cmpgt_epi32(topLimit, y), _mm_cmpgt_epi32(y, bottomLimit));
+            culled = _mm_or_si128(culled, out[half]);
+        }
+        storeDead(b.dead + i, out[0], out[1]);
+    }
+    bool any = _mm_movemask_epi8(culled) != 0;
+    return scalarRange(b, i, end, top, bottom) || any;
+}
+
+STG_TARGET_AVX2 __m256i avx2Axis(int* position, int* previous, int* speed, const int* accel) {
+    __m256i v = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(speed)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accel)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(speed), v);
+    __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(previous), old);
+    __m256i p = _mm256_add_epi32(old, v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(position), p);
+    return p;
+}
+
+STG_TARGET_AVX2 bool avx2Kernel(const BulletStreams& b, int begin, int end, int top, int bottom) {
+    const __m256i topLimit = _mm256_set1_epi32(top);
+    const __m256i bottomLimit = _mm256_set1_epi32(bottom);
+    __m256i culled = _mm256_setzero_si256();
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        avx2Axis(b.x + i, b.prevX + i, b.speedX + i, b.accelX + i);
+        __m256i y = avx2Axis(b.y + i, b.prevY + i, b.speedY + i, b.accelY + i);
+        __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(topLimit, y), _mm256_cmpgt_epi32(y, bottomLimit));
+        culled = _mm256_or_si256(culled, out);
+        storeDead(b.dead + i, _mm256_castsi256_si128(out), _mm256_extracti128_si256(out, 1));
+    }
+    bool any = _mm256_movemask_epi8(culled) != 0;
+    return scalarRange(b, i, end, top, bottom) || any;
+}
+
+#endif
+
+struct IntegrateDispatch {
+    IntegrateFunction function;
+    const char* name;
+};
+
+IntegrateDispatch selectKernel() {
+#if STG_X86
+    if (cpuHasAvx2()) {
+        return IntegrateDispatch{ avx2Kernel, "AVX2" };
+    }
+    if (cpuHasSse2()) {
+        return IntegrateDispatch{ sse2Kernel, "SSE2" };
+    }
+#endif
+    return IntegrateDispatch{ integrateBulletsScalar, "scalar" };
+}
+
+const IntegrateDispatch& dispatch() {
+    static const IntegrateDispatch selected = selectKernel();
+    return selected;
+}
+
+}
+
+bool integrateBulletsScalar(const BulletStreams& bullets, int begin, int end, int top, int bottom) {
+    return scalarRange(bullets, begin, end, top, bottom);
+}
+
+#if STG_X86
+const IntegrateFunction integrateBulletsSse2 = cpuHasSse2() ? sse2Kernel : nullptr;
+const IntegrateFunction integrateBulletsAvx2 = cpuHasAvx2() ? avx2Kernel : nullptr;
+#else
+const IntegrateFunction integrateBulletsSse2 = nullptr;
+const IntegrateFunction integrateBulletsAvx2 = nullptr;
+#endif
+
+IntegrateFunction integrateBullets() {
+    return dispatch().function;
+}
+
+const char* integrateBulletsName() {
+    return dispatch().name;
+}
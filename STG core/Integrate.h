@@ -0,0 +1,30 @@
+﻿#pragma once
+#include <cstdint>
+
+// 一段子弹的 SoA 数据。位置、速度和加速度均为 16.16 定点数，每个分量连续存放，SIMD 可直接整块加载
+struct BulletStreams {
+    int* x;
+    int* y;
+    int* prevX;     // 移动前的位置，用于渲染插值
+    int* prevY;
+    int* speedX;
+    int* speedY;
+    const int* accelX;
+    const int* accelY;
+    uint8_t* dead;
+};
+
+// 移动下标在 [begin, end) 之间的子弹：先把加速度加到速度上，保存原位置后按新速度移动
+// 移动后 y 不在 [top, bottom]（定点数）内的子弹标记为 dead，返回是否有子弹被标记
+typedef bool (*IntegrateFunction)(const BulletStreams& bullets, int begin, int end, int top, int bottom);
+
+// 启动时按 CPU 支持的指令集选一次：AVX2（每条指令 8 颗子弹）、SSE2（4 颗）或标量
+IntegrateFunction integrateBullets();
+
+// 当前使用的实现名称
+const char* integrateBulletsName();
+
+// 各个实现，基准测试可以直接比较；CPU 不支持时对应指针为空
+bool integrateBulletsScalar(const BulletStreams& bullets, int begin, int end, int top, int bottom);
+extern const IntegrateFunction integrateBulletsSse2;
+extern const IntegrateFunction integrateBulletsAvx2;
@@ -0,0 +1,138 @@
+﻿#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+thread_local uint32_t ProfileScope::depth = 0;
+
+namespace {
+
+uint64_t steadyClock() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() : clockFunction(steadyClock), frequency(1000000000), frameIndex(0) {
+}
+
+ProfileRing& Profiler::threadRing() {
+    // 缓冲区在程序结束前一直保留，线程退出后其中的事件仍然可以读取
+    thread_local ProfileRing* ring = nullptr;
+    if (ring == nullptr) {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        ring = new ProfileRing(static_cast<uint32_t>(rings.size()));
+        rings.push_back(ring);
+        readPositions.push_back(0);
+    }
+    return *ring;
+}
+
+int Profiler::findZone(int parent, const char* name, int depth) {
+    for (size_t i = 0; i < zones.size(); ++i) {
+        if (zones[i].parent == parent && zones[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    ZoneStats zone = {};
+    zone.name = name;
+    zone.parent = parent;
+    zone.depth = depth;
+    zones.push_back(zone);
+    order.clear(); // 出现新区间，重新计算显示顺序
+    return static_cast<int>(zones.size()) - 1;
+}
+
+void Profiler::capture(uint64_t since, std::vector<ProfileEvent>& out) {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (auto ring : rings) {
+        size_t first = out.size();
+        ring->copy(0, out);
+        out.erase(std::remove_if(out.begin() + first, out.end(), [since](const ProfileEvent& event) {
+            return event.end < since;
+        }), out.end());
+    }
+}
+
+void Profiler::endFrame() {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (size_t r = 0; r < rings.size(); ++r) {
+        frameEvents.clear();
+        readPositions[r] = rings[r]->copy(readPositions[r], frameEvents);
+
+        // 按开始时间排序后父区间总在子区间之前，用栈还原调用层级
+        std::sort(frameEvents.begin(), frameEvents.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+            return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+        });
+        int stack[64];
+        uint32_t stackDepth[64];
+        int top = 0;
+        for (const auto& event : frameEvents) {
+            while (top > 0 && stackDepth[top - 1] >= event.depth) {
+                top--;
+            }
+            int parent = top > 0 ? stack[top - 1] : -1;
+            int zone = findZone(parent, event.name, top);
+            zones[zone].frameTotal += event.end - event.start;
+            zones[zone].frameAllocations += event.allocations;
+            if (top < 64) {
+                stack[top] = zone;
+                stackDepth[top] = event.depth;
+                top++;
+            }
+        }
+    }
+
+    // 更新每个区间最近 WINDOW 帧耗时和堆分配次数的平均值和最大值
+    const int window = ZoneStats::WINDOW; // std::min 按引用取参数，复制一份以免需要类外定义
+    int slot = frameIndex % window;
+    int frames = (std::min)(frameIndex + 1, window);
+    double msPerTick = 1000.0 / frequency;
+    for (auto& zone : zones) {
+        zone.history[slot] = zone.frameTotal;
+        zone.frameTotal = 0;
+        zone.allocationHistory[slot] = zone.frameAllocations;
+        zone.frameAllocations = 0;
+        uint64_t sum = 0;
+        uint64_t worst = 0;
+        uint64_t allocationSum = 0;
+        uint64_t allocationWorst = 0;
+        for (int i = 0; i < frames; ++i) {
+            sum += zone.history[i];
+            worst = (std::max)(worst, zone.history[i]);
+            allocationSum += zone.allocationHistory[i];
+            allocationWorst = (std::max)(allocationWorst, zone.allocationHistory[i]);
+        }
+        zone.averageMs = static_cast<double>(sum) / frames * msPerTick;
+        zone.worstMs = worst * msPerTick;
+        zone.averageAllocations = static_cast<double>(allocationSum) / frames;
+        zone.worstAllocations = allocationWorst;
+    }
+    frameIndex++;
+
+    if (order.size() != zones.size()) {
+        // 深度优先排列：每个区间紧跟在父区间之后
+        order.clear();
+        std::vector<int> pending;
+        for (int i = static_cast<int>(zones.size()) - 1; i >= 0; --i) {
+            if (zones[i].parent < 0) {
+                pending.push_back(i);
+            }
+        }
+        while (!pending.empty()) {
+            int zone = pending.back();
+            pending.pop_back();
+            order.push_back(zone);
+            for (int i = static_cast<int>(zones.size()) - 1; i >= 0; --i) {
+                if (zones[i].parent == zone) {
+                    pending.push_back(i);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,175 @@
+﻿#pragma once
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 性能分析开关：调试版默认开启，发布版默认完全移除，也可以在工程中定义 STG_PROFILING=1 强制开启
+#ifndef STG_PROFILING
+#ifdef _DEBUG
+#define STG_PROFILING 1
+#else
+#define STG_PROFILING 0
+#endif
+#endif
+
+// 一个分析区间，在区间结束时写入
+struct ProfileEvent {
+    const char* name; // 必须是字符串常量
+    uint64_t start;
+    uint64_t end;
+    uint32_t depth;   // 嵌套深度，最外层为 0
+    uint32_t thread;  // 所在线程的缓冲区编号
+    uint32_t allocations; // 区间内（含子区间）的堆分配次数
+};
+
+// 每个线程一个环形缓冲区：只有所属线程写入，其他线程只读，不需要加锁
+// 缓冲区写满后覆盖最旧的事件
+class ProfileRing {
+public:
+    static const uint32_t CAPACITY = 16384; // 必须是 2 的幂
+
+    uint32_t threadId;
+
+    ProfileRing(uint32_t id) : threadId(id), events(CAPACITY), head(0) {}
+
+    void push(const ProfileEvent& event) {
+        uint64_t index = head.load(std::memory_order_relaxed);
+        events[index & (CAPACITY - 1)] = event;
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    // 已写入的事件总数
+    uint64_t written() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+    // 复制编号在 [from, written()) 之间且仍未被覆盖的事件，返回复制后的位置
+    uint64_t copy(uint64_t from, std::vector<ProfileEvent>& out) const {
+        uint64_t to = written();
+        if (to - from > CAPACITY) {
+            from = to - CAPACITY;
+        }
+        size_t first = out.size();
+        for (uint64_t i = from; i < to; ++i) {
+            out.push_back(events[i & (CAPACITY - 1)]);
+        }
+        // 复制过程中被写入线程覆盖的事件不可信，丢弃
+        uint64_t after = written();
+        if (after - from > CAPACITY) {
+            size_t overwritten = static_cast<size_t>((std::min)(after - from - CAPACITY, to - from));
+            out.erase(out.begin() + first, out.begin() + first + overwritten);
+        }
+        return to;
+    }
+
+private:
+    std::vector<ProfileEvent> events;
+    std::atomic<uint64_t> head;
+};
+
+// 每个分析区间的统计，按调用层级组织：同名区间在不同父区间下分别统计
+struct ZoneStats {
+    static const int WINDOW = 120; // 统计最近的帧数
+
+    const char* name;
+    int parent;     // 父区间在 zones 中的下标，最外层为 -1
+    int depth;
+    uint64_t frameTotal;          // 本帧累计耗时（计数器单位）
+    uint64_t history[WINDOW];     // 最近每帧的耗时
+    double averageMs;
+    double worstMs;
+    uint64_t frameAllocations;               // 本帧累计的堆分配次数
+    uint64_t allocationHistory[WINDOW];      // 最近每帧的堆分配次数
+    double averageAllocations;
+    uint64_t worstAllocations;
+};
+
+class Profiler {
+public:
+    typedef uint64_t (*ClockFunction)();
+
+    static Profiler& instance();
+
+    // 设置计时函数，前端使用 SDL_GetPerformanceCounter，默认使用 std::chrono::steady_clock
+    void setClock(ClockFunction function, uint64_t ticksPerSecond) {
+        clockFunction = function;
+        frequency = ticksPerSecond;
+    }
+
+    uint64_t now() const {
+        return clockFunction();
+    }
+
+    uint64_t ticksPerSecond() const {
+        return frequency;
+    }
+
+    // 当前线程的缓冲区，第一次调用时注册
+    ProfileRing& threadRing();
+
+    // 每帧结束时调用：收集本帧的区间并更新统计
+    void endFrame();
+
+    // 复制所有线程中在 since 之后结束、仍保存在缓冲区里的区间，用于导出时间线
+    void capture(uint64_t since, std::vector<ProfileEvent>& out);
+
+    // 按调用层级排好顺序的区间统计（深度优先）
+    const std::vector<int>& displayOrder() const {
+        return order;
+    }
+
+    std::vector<ZoneStats> zones;
+
+private:
+    Profiler();
+
+    int findZone(int parent, const char* name, int depth);
+
+    ClockFunction clockFunction;
+    uint64_t frequency;
+
+    std::mutex ringsMutex; // 只在注册新线程和遍历线程列表时使用
+    std::vector<ProfileRing*> rings;
+    std::vector<uint64_t> readPositions;
+
+    std::vector<ProfileEvent> frameEvents;
+    std::vector<int> order;
+    int frameIndex;
+};
+
+// 作用域计时：构造时记录开始时间，析构时把区间写入当前线程的缓冲区
+class ProfileScope {
+public:
+    ProfileScope(const char* zoneName) : name(zoneName), start(Profiler::instance().now()), startAllocations(threadAllocations().count) {
+        depth++;
+    }
+
+    ~ProfileScope() {
+        depth--;
+        Profiler& profiler = Profiler::instance();
+        ProfileRing& ring = profiler.threadRing();
+        uint32_t allocations = static_cast<uint32_t>(threadAllocations().count - startAllocations);
+        ProfileEvent event = { name, start, profiler.now(), depth, ring.threadId, allocations };
+        ring.push(event);
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+    uint64_t startAllocations;
+    static thread_local uint32_t depth;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if STG_PROFILING
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,187 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// 实体句柄：槽位编号 + 代数。实体销毁后槽位的代数加一，指向它的旧句柄随之失效
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const Entity& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const Entity& other) const {
+        return !(*this == other);
+    }
+};
+
+// 实体表：同一类实体的组件按列存放，每种组件一个稠密数组，第 row 行是按创建顺序排列的第 row 个存活实体
+// 系统只取自己需要的列顺序遍历；句柄经槽位表映射到行，行号在 compact() 后会变化，跨帧保存实体时应使用句柄
+// 逻辑帧中只用 kill() 标记实体，帧末由 compact() 一次性回收，遍历过程中行号保持不变
+template <typename... Components>
+class EntityTable {
+public:
+    EntityTable() : pendingRemoval(false) {}
+
+    int size() const {
+        return static_cast<int>(rowEntity.size());
+    }
+
+    bool empty() const {
+        return rowEntity.empty();
+    }
+
+    // 预留 count 个实体的空间，实体数不超过它时创建和回收都不再分配内存
+    void reserve(int count) {
+        reserveColumns(std::index_sequence_for<Components...>(), count);
+        rowEntity.reserve(count);
+        dead.reserve(count);
+        slotRow.reserve(count);
+        slotGeneration.reserve(count);
+        freeSlots.reserve(count);
+    }
+
+    // 创建实体并追加到表尾，优先复用空闲槽位
+    Entity create(const Components&... values) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<uint32_t>(slotGeneration.size());
+            slotGeneration.push_back(0);
+            slotRow.push_back(-1);
+        }
+        slotRow[slot] = size();
+        Entity entity = { slot, slotGeneration[slot] };
+        rowEntity.push_back(entity);
+        dead.push_back(0);
+        pushColumns(std::index_sequence_for<Components...>(), values...);
+        return entity;
+    }
+
+    // 被 kill() 标记但尚未 compact() 的实体仍然存活
+    bool alive(Entity entity) const {
+        return entity.index < slotGeneration.size() && slotGeneration[entity.index] == entity.generation && slotRow[entity.index] >= 0;
+    }
+
+    // 实体所在的行，实体已销毁时返回 -1
+    int row(Entity entity) const {
+        return alive(entity) ? slotRow[entity.index] : -1;
+    }
+
+    Entity entity(int row) const {
+        return rowEntity[row];
+    }
+
+    // 某种组件的整列，下标为行号
+    template <typename T>
+    std::vector<T>& column() {
+        return std::get<std::vector<T>>(columns);
+    }
+
+    template <typename T>
+    const std::vector<T>& column() const {
+        return std::get<std::vector<T>>(columns);
+    }
+
+    template <typename T>
+    T& get(Entity entity) {
+        return column<T>()[slotRow[entity.index]];
+    }
+
+    // 标记实体在本帧被销毁：行仍然保留到 compact()，系统遍历时应跳过
+    void kill(int row) {
+        dead[row] = 1;
+        pendingRemoval = true;
+    }
+
+    void kill(Entity entity) {
+        if (alive(entity)) {
+            kill(slotRow[entity.index]);
+        }
+    }
+
+    bool killed(int row) const {
+        return dead[row] != 0;
+    }
+
+    // 一次线性扫描回收所有被标记的实体，保持剩余实体的顺序
+    void compact() {
+        if (!pendingRemoval) {
+            return;
+        }
+        int kept = 0;
+        for (int r = 0; r < size(); ++r) {
+            if (dead[r]) {
+                releaseSlot(rowEntity[r]);
+                continue;
+            }
+            if (kept != r) {
+                moveColumns(std::index_sequence_for<Components...>(), r, kept);
+                rowEntity[kept] = rowEntity[r];
+                slotRow[rowEntity[kept].index] = kept;
+            }
+            kept++;
+        }
+        resizeColumns(std::index_sequence_for<Components...>(), kept);
+        rowEntity.resize(kept);
+        dead.assign(kept, 0);
+        pendingRemoval = false;
+    }
+
+    // 销毁所有实体，槽位的代数照常增加
+    void clear() {
+        for (const Entity& entity : rowEntity) {
+            releaseSlot(entity);
+        }
+        resizeColumns(std::index_sequence_for<Components...>(), 0);
+        rowEntity.clear();
+        dead.clear();
+        pendingRemoval = false;
+    }
+
+private:
+    // 对每一列执行同一个操作（C++14 没有折叠表达式，借助数组初始化展开参数包）
+    template <std::size_t... I>
+    void pushColumns(std::index_sequence<I...>, const Components&... values) {
+        int expand[] = { 0, (std::get<I>(columns).push_back(values), 0)... };
+        (void)expand;
+    }
+
+    template <std::size_t... I>
+    void reserveColumns(std::index_sequence<I...>, int count) {
+        int expand[] = { 0, (std::get<I>(columns).reserve(count), 0)... };
+        (void)expand;
+    }
+
+    template <std::size_t... I>
+    void moveColumns(std::index_sequence<I...>, int from, int to) {
+        int expand[] = { 0, (std::get<I>(columns)[to] = std::get<I>(columns)[from], 0)... };
+        (void)expand;
+    }
+
+    template <std::size_t... I>
+    void resizeColumns(std::index_sequence<I...>, int count) {
+        int expand[] = { 0, (std::get<I>(columns).resize(count), 0)... };
+        (void)expand;
+    }
+
+    void releaseSlot(const Entity& entity) {
+        slotRow[entity.index] = -1;
+        slotGeneration[entity.index]++;
+        freeSlots.push_back(entity.index);
+    }
+
+    std::tuple<std::vector<Components>...> columns;
+    std::vector<Entity> rowEntity;          // 每行对应的实体
+    std::vector<uint8_t> dead;              // 每行是否已被标记销毁
+    std::vector<int> slotRow;               // 槽位 -> 行，空闲槽位为 -1
+    std::vector<uint32_t> slotGeneration;   // 槽位的当前代数
+    std::vector<uint32_t> freeSlots;
+    bool pendingRemoval;
+};
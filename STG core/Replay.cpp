@@ -0,0 +1,139 @@
+﻿#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char REPLAY_MAGIC[4] = { 'S', 'T', 'G', 'R' };
+const uint8_t REPLAY_VERSION = 4; // 2：子弹按阵营分池；3：子弹速度改为亚像素单位；4：位置改为定点数。每次都改变了状态哈希
+
+void writeUint(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+// 变长整数：每字节 7 位，最高位表示后面还有字节
+void writeVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+class Reader {
+public:
+    Reader(const std::vector<uint8_t>& bytes) : data(bytes), pos(0), ok(true) {}
+
+    uint64_t readUint(int bytes) {
+        if (pos + bytes > data.size()) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[pos++]) << (i * 8);
+        }
+        return value;
+    }
+
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= data.size()) {
+                ok = false;
+                return 0;
+            }
+            uint8_t b = data[pos++];
+            value |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    const std::vector<uint8_t>& data;
+    size_t pos;
+    bool ok;
+};
+
+}
+
+bool ReplayRecorder::save(const std::string& path, int tickRate, uint32_t finalHash) const {
+    std::vector<uint8_t> out;
+    out.insert(out.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    writeUint(out, REPLAY_VERSION, 1);
+    writeUint(out, static_cast<uint64_t>(tickRate), 2);
+    writeUint(out, seed, 8);
+    writeUint(out, ticks, 4);
+    writeUint(out, finalHash, 4);
+    writeUint(out, runs.size(), 4);
+    for (const auto& run : runs) {
+        out.push_back(run.buttons);
+        writeVarint(out, run.count);
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Unable to write replay " << path << "!" << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    std::fclose(file);
+    if (!written) {
+        std::cerr << "Unable to write replay " << path << "!" << std::endl;
+    }
+    return written;
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Unable to open replay " << path << "!" << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+
+    if (bytes.size() < 4 || std::memcmp(bytes.data(), REPLAY_MAGIC, 4) != 0) {
+        std::cerr << "Invalid replay file " << path << "!" << std::endl;
+        return false;
+    }
+    Reader reader(bytes);
+    reader.pos = 4;
+    uint64_t version = reader.readUint(1);
+    if (version != REPLAY_VERSION) {
+        std::cerr << "Unsupported replay version " << version << " in " << path << "!" << std::endl;
+        return false;
+    }
+    tickRate = static_cast<int>(reader.readUint(2));
+    seed = reader.readUint(8);
+    ticks = static_cast<uint32_t>(reader.readUint(4));
+    finalHash = static_cast<uint32_t>(reader.readUint(4));
+    uint32_t runCount = static_cast<uint32_t>(reader.readUint(4));
+
+    runs.clear();
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < runCount && reader.ok; ++i) {
+        uint8_t buttons = static_cast<uint8_t>(reader.readUint(1));
+        uint32_t count = reader.readVarint();
+        runs.push_back(ReplayRun{ buttons, count });
+        total += count;
+    }
+    if (!reader.ok || total != ticks || tickRate <= 0) {
+        std::cerr << "Corrupted replay file " << path << "!" << std::endl;
+        runs.clear();
+        return false;
+    }
+    rewind();
+    return true;
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+#include "SimTypes.h"
+#include <string>
+#include <vector>
+
+// 录像：保存种子和每个逻辑帧的输入位掩码，连续相同的输入按游程编码
+//
+// 文件格式（小端）：
+//   "STGR"  版本(u8)  模拟频率(u16)  种子(u64)  帧数(u32)  结束时状态哈希(u32)  游程数(u32)
+//   每个游程：输入位掩码(u8) + 重复帧数(变长整数)
+struct ReplayRun {
+    uint8_t buttons;
+    uint32_t count;
+};
+
+class ReplayRecorder {
+public:
+    static const size_t RESERVED_RUNS = 16384; // 预留的游程数，足够很长的一局，录制时不再分配
+
+    uint64_t seed;
+    uint32_t ticks;
+    std::vector<ReplayRun> runs;
+
+    ReplayRecorder() : seed(0), ticks(0) {
+        runs.reserve(RESERVED_RUNS);
+    }
+
+    void begin(uint64_t newSeed) {
+        seed = newSeed;
+        ticks = 0;
+        runs.clear(); // 保留容量，下一局同样不需要重新分配
+    }
+
+    void record(const Input& input) {
+        if (!runs.empty() && runs.back().buttons == input.buttons) {
+            runs.back().count++;
+        }
+        else {
+            runs.push_back(ReplayRun{ input.buttons, 1 });
+        }
+        ticks++;
+    }
+
+    bool save(const std::string& path, int tickRate, uint32_t finalHash) const;
+};
+
+class ReplayPlayer {
+public:
+    int tickRate;
+    uint64_t seed;
+    uint32_t ticks;
+    uint32_t finalHash;
+    std::vector<ReplayRun> runs;
+
+    ReplayPlayer() : tickRate(0), seed(0), ticks(0), finalHash(0), runIndex(0), runOffset(0) {}
+
+    bool load(const std::string& path);
+
+    // 回到第一帧
+    void rewind() {
+        runIndex = 0;
+        runOffset = 0;
+    }
+
+    // 取出下一帧的输入，录像结束时返回 false
+    bool next(Input& input) {
+        while (runIndex < runs.size() && runOffset >= runs[runIndex].count) {
+            runIndex++;
+            runOffset = 0;
+        }
+        if (runIndex >= runs.size()) {
+            return false;
+        }
+        input.buttons = runs[runIndex].buttons;
+        runOffset++;
+        return true;
+    }
+
+private:
+    size_t runIndex;
+    uint32_t runOffset;
+};
@@ -0,0 +1,60 @@
+﻿#pragma once
+#include <cstdint>
+
+// xoshiro128** 随机数生成器：状态只有 16 字节，同一种子在任何平台上产生相同序列
+class Rng {
+public:
+    Rng() {
+        seed(0, 0);
+    }
+
+    // 用 splitmix64 把 (种子, 流编号) 展开为初始状态，不同流之间互不相关
+    void seed(uint64_t value, uint64_t stream) {
+        uint64_t sm = value ^ (stream * 0xD1B54A32D192ED03ULL);
+        uint64_t a = splitmix64(sm);
+        uint64_t b = splitmix64(sm);
+        s[0] = static_cast<uint32_t>(a);
+        s[1] = static_cast<uint32_t>(a >> 32);
+        s[2] = static_cast<uint32_t>(b);
+        s[3] = static_cast<uint32_t>(b >> 32);
+        if ((s[0] | s[1] | s[2] | s[3]) == 0) {
+            s[0] = 1; // 全零状态无法产生随机数
+        }
+    }
+
+    uint32_t next() {
+        uint32_t result = rotl(s[1] * 5, 7) * 9;
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // [0, n) 内的整数，用乘法取高位代替取模
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32);
+    }
+
+    // [lo, hi) 内的整数
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(below(static_cast<uint32_t>(hi - lo)));
+    }
+
+private:
+    uint32_t s[4];
+
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
@@ -0,0 +1,130 @@
+﻿#pragma once
+#include <cstdint>
+
+// 模拟核心使用的基础类型，不依赖 SDL
+
+const int SCREEN_WIDTH = 800;
+const int SCREEN_HEIGHT = 600;
+const int MAX_BULLETS = 16384; // 子弹池容量
+const int ENEMY_CAPACITY = 256; // 预留的敌人数量，超出时敌人表照常增长
+const int GRID_CELL_SIZE = 50;  // 碰撞网格的格子大小，与敌人尺寸一致
+const int TICK_RATE = 60;       // 固定模拟频率（每秒逻辑帧数）
+const int FIXED_SHIFT = 16;     // 位置、速度和加速度使用 16.16 定点数
+const int FIXED_ONE = 1 << FIXED_SHIFT;
+
+// 16.16 定点数：高 16 位为整数像素，低 16 位为像素的小数部分
+typedef int32_t Fixed;
+
+inline Fixed toFixed(int pixels) {
+    return pixels * FIXED_ONE;
+}
+
+// 向下取整到像素（算术右移，负数同样向下取整）
+inline int toPixels(Fixed value) {
+    return value >> FIXED_SHIFT;
+}
+
+// 按比例 t（定点数，0 到 FIXED_ONE）在 from 和 to 之间插值
+inline Fixed lerpFixed(Fixed from, Fixed to, Fixed t) {
+    return from + static_cast<Fixed>((static_cast<int64_t>(to - from) * t) >> FIXED_SHIFT);
+}
+
+// 按每秒像素给出的速度换算为每逻辑帧的位移，修改 TICK_RATE 时实际速度不变
+inline Fixed perTick(int pixelsPerSecond) {
+    return static_cast<Fixed>(static_cast<int64_t>(pixelsPerSecond) * FIXED_ONE / TICK_RATE);
+}
+
+struct Rect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+// 与 SDL_HasIntersection 相同：空矩形不相交，边缘相接不算相交
+inline bool intersects(const Rect& a, const Rect& b) {
+    if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0) {
+        return false;
+    }
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// 一个逻辑帧的输入，按位存放
+enum InputButton : uint8_t {
+    INPUT_UP = 1 << 0,
+    INPUT_DOWN = 1 << 1,
+    INPUT_LEFT = 1 << 2,
+    INPUT_RIGHT = 1 << 3,
+    INPUT_FIRE = 1 << 4
+};
+
+struct Input {
+    uint8_t buttons;
+
+    bool held(InputButton button) const {
+        return (buttons & button) != 0;
+    }
+};
+
+// 实体组件：每种组件在实体表中单独成列，系统只访问需要的列
+
+// 左上角位置及上一逻辑帧的位置（用于渲染插值），均为定点数
+struct Transform {
+    Fixed x;
+    Fixed y;
+    Fixed prevX;
+    Fixed prevY;
+};
+
+// 每个逻辑帧的位移（定点数）
+struct Velocity {
+    Fixed dx;
+    Fixed dy;
+};
+
+// 碰撞盒和绘制尺寸（像素）
+struct Hitbox {
+    int w;
+    int h;
+};
+
+struct PlayerState {
+    Transform transform;
+    Hitbox hitbox;
+    int lives;
+    uint32_t lastShotTime;
+    uint32_t shotInterval;
+    int extraBulletCount;      // 额外弹幕的数量
+    int enemyKillCount;        // 击杀敌人的计数器
+};
+
+// 射击计时
+struct Weapon {
+    uint32_t lastShotTime;
+    uint32_t interval;
+};
+
+// 绘制时使用的图片，由前端映射到图集中的精灵
+enum SpriteKind : uint8_t {
+    SPRITE_PLAYER,
+    SPRITE_ENEMY,
+    SPRITE_KIND_COUNT
+};
+
+struct Sprite {
+    SpriteKind kind;
+};
+
+// 碰撞检测使用的像素矩形，位置向下取整
+inline Rect rectOf(const Transform& t, const Hitbox& h) {
+    return Rect{ toPixels(t.x), toPixels(t.y), h.w, h.h };
+}
+
+// 绘制用的矩形：在上一逻辑帧 (prevX, prevY) 和当前位置 (x, y) 之间按比例 t 做定点数插值，最后才转换为像素
+inline Rect interpolateRect(Fixed prevX, Fixed prevY, Fixed x, Fixed y, int w, int h, Fixed t) {
+    return Rect{ toPixels(lerpFixed(prevX, x, t)), toPixels(lerpFixed(prevY, y, t)), w, h };
+}
+
+inline Rect interpolateRect(const Transform& transform, const Hitbox& h, Fixed t) {
+    return interpolateRect(transform.prevX, transform.prevY, transform.x, transform.y, h.w, h.h, t);
+}
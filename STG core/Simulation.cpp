@@ -0,0 +1,409 @@
+﻿#include "Simulation.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace {
+
+// 运动速度以像素每秒给出，按 TICK_RATE 换算为每帧的定点数位移
+const int PLAYER_SPEED = 300;         // 玩家移动
+const int PLAYER_BULLET_SPEED = 600;  // 玩家子弹向上的速度
+const int SPREAD_SPEED_STEP = 300;    // 每对额外弹幕增加的横向速度
+const int ENEMY_SPEED = 120;          // 敌人下落
+const int ENEMY_SPREAD_STEP = 60;     // 敌人散射子弹每对增加的横向速度
+
+}
+
+Simulation::Simulation()
+    : playerBullets(MAX_BULLETS),
+    enemyBullets(MAX_BULLETS),
+    enemyGrid(SCREEN_WIDTH, SCREEN_HEIGHT, GRID_CELL_SIZE),
+    playerHits(FrameArena::current()),
+    enemyHits(FrameArena::current()),
+    aabbKernel(aabbBatch()),
+    score(0),
+    enemySpawnRate(3000),
+    minSpawnRate(200),
+    lastEnemySpawnTime(0),
+    enemyKillCount(0),
+    tick(0),
+    clock(0.0),
+    gameOver(false),
+    finalGameTime(0),
+    seed(0),
+    enemyBulletSpeed(300),
+    enemySpread(1),
+    invulnerable(false) {
+    // 预先分配，稳态的逻辑帧不再分配内存
+    enemies.reserve(ENEMY_CAPACITY);
+    enemyGrid.reserve(ENEMY_CAPACITY);
+    reset(0);
+}
+
+void Simulation::reset(uint64_t newSeed) {
+    player = PlayerState{ Transform{ toFixed(400), toFixed(500), toFixed(400), toFixed(500) }, Hitbox{ 50, 50 }, 3, 0, 300, 0, 0 };
+    enemies.clear();
+    playerBullets.clear();
+    enemyBullets.clear();
+    score = 0;
+    enemySpawnRate = 3000;
+    lastEnemySpawnTime = 0;
+    enemyKillCount = 0;
+    tick = 0;
+    clock = 0.0;
+    gameOver = false;
+    finalGameTime = 0;
+    seed = newSeed;
+    spawnRng.seed(seed, STREAM_SPAWN);
+    fireRng.seed(seed, STREAM_FIRE);
+    effectsRng.seed(seed, STREAM_EFFECTS);
+}
+
+void Simulation::step(const Input& input, double dt) {
+    if (gameOver) {
+        return;
+    }
+    PROFILE_ZONE("step");
+
+    // 保存上一逻辑帧的位置，用于渲染插值
+    player.transform.prevX = player.transform.x;
+    player.transform.prevY = player.transform.y;
+    for (auto& transform : enemies.column<Transform>()) {
+        transform.prevX = transform.x;
+        transform.prevY = transform.y;
+    }
+
+    handlePlayerInput(input);
+
+    // 已有的敌人子弹本帧需要移动，敌人接下来发射的子弹不移动
+    int movedEnemyBullets = enemyBullets.count;
+
+    // 更新敌人位置并发射子弹
+    updateEnemies();
+
+    // 移动子弹、剔除出屏子弹并检测子弹与敌人、玩家的碰撞
+    updatePlayerBullets(playerBullets.count);
+    updateEnemyBullets(movedEnemyBullets);
+    resolveHits();
+
+    // 检测玩家与敌人的碰撞
+    checkPlayerEnemyCollision();
+
+    // 检测敌人是否到达屏幕底部
+    checkEnemyBottomCollision();
+
+    // 生成新的敌人
+    spawnEnemy();
+
+    // 各个系统只做标记，在这里一次性回收本帧被销毁的敌人和子弹
+    enemies.compact();
+    playerBullets.compact();
+    enemyBullets.compact();
+
+    // 本帧的命中事件到此失效，由调用方在帧末回收 FrameArena
+    playerHits = FrameVector<BulletHit>(FrameArena::current());
+    enemyHits = FrameVector<BulletHit>(FrameArena::current());
+
+    // 推进模拟时间
+    tick++;
+    clock += dt;
+
+    // 检查玩家生命值，若为0则进入游戏结束状态
+    if (player.lives <= 0) {
+        gameOver = true;
+        finalGameTime = simTime() / 1000;  // 记录游戏结束时间（秒）
+    }
+}
+
+namespace {
+
+// FNV-1a，逐个混入 32 位整数
+void hashInt(uint32_t& h, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        h ^= (value >> (i * 8)) & 0xFF;
+        h *= 16777619u;
+    }
+}
+
+// 位置按定点数混入，小数部分同样影响哈希
+void hashBody(uint32_t& h, const Transform& t, const Hitbox& box) {
+    hashInt(h, static_cast<uint32_t>(t.x));
+    hashInt(h, static_cast<uint32_t>(t.y));
+    hashInt(h, static_cast<uint32_t>(box.w));
+    hashInt(h, static_cast<uint32_t>(box.h));
+}
+
+}
+
+uint32_t Simulation::stateHash() const {
+    uint32_t h = 2166136261u;
+    hashInt(h, static_cast<uint32_t>(tick));
+    hashInt(h, static_cast<uint32_t>(score));
+    hashInt(h, static_cast<uint32_t>(enemyKillCount));
+    hashBody(h, player.transform, player.hitbox);
+    hashInt(h, static_cast<uint32_t>(player.lives));
+    hashInt(h, player.lastShotTime);
+    hashInt(h, player.shotInterval);
+    hashInt(h, static_cast<uint32_t>(player.extraBulletCount));
+    const std::vector<Transform>& transforms = enemies.column<Transform>();
+    const std::vector<Hitbox>& hitboxes = enemies.column<Hitbox>();
+    const std::vector<Weapon>& weapons = enemies.column<Weapon>();
+    for (int e = 0; e < enemies.size(); ++e) {
+        hashBody(h, transforms[e], hitboxes[e]);
+        hashInt(h, weapons[e].lastShotTime);
+        hashInt(h, weapons[e].interval);
+    }
+    for (const BulletPool* pool : { &playerBullets, &enemyBullets }) {
+        hashInt(h, static_cast<uint32_t>(pool->count));
+        for (int i = 0; i < pool->count; ++i) {
+            hashInt(h, static_cast<uint32_t>(pool->x[i]));
+            hashInt(h, static_cast<uint32_t>(pool->y[i]));
+            hashInt(h, static_cast<uint32_t>(pool->speedX[i]));
+            hashInt(h, static_cast<uint32_t>(pool->speedY[i]));
+            hashInt(h, static_cast<uint32_t>(pool->accelX[i]));
+            hashInt(h, static_cast<uint32_t>(pool->accelY[i]));
+        }
+    }
+    return h;
+}
+
+void Simulation::handlePlayerInput(const Input& input) {
+    Transform& t = player.transform;
+    const Hitbox& box = player.hitbox;
+    const Fixed speed = perTick(PLAYER_SPEED);
+    Fixed moveX = 0;
+    Fixed moveY = 0;
+    if (input.held(INPUT_UP)) moveY = -speed;
+    if (input.held(INPUT_DOWN)) moveY = speed;
+    if (input.held(INPUT_LEFT)) moveX = -speed;
+    if (input.held(INPUT_RIGHT)) moveX = speed;
+
+    t.x += moveX;
+    t.y += moveY;
+
+    if (t.y < 0) t.y = 0;
+    if (t.y > toFixed(SCREEN_HEIGHT - box.h)) t.y = toFixed(SCREEN_HEIGHT - box.h);
+    if (t.x < 0) t.x = 0;
+    if (t.x > toFixed(SCREEN_WIDTH - box.w)) t.x = toFixed(SCREEN_WIDTH - box.w);
+
+    uint32_t currentTime = simTime();
+    if (input.held(INPUT_FIRE) && currentTime - player.lastShotTime >= player.shotInterval) {
+        // 发射主弹幕
+        Fixed muzzleX = t.x + toFixed(box.w / 2 - 2);
+        Fixed bulletSpeed = -perTick(PLAYER_BULLET_SPEED);
+        playerBullets.spawn(muzzleX, t.y, 0, bulletSpeed);
+
+        // 根据 extraBulletCount 增加额外的斜方向弹幕
+        for (int i = 0; i < player.extraBulletCount; ++i) {
+            Fixed offset = perTick(SPREAD_SPEED_STEP * (i + 1)); // 每个额外弹幕的横向速度
+            playerBullets.spawn(muzzleX, t.y, -offset, bulletSpeed); // 左斜弹幕
+            playerBullets.spawn(muzzleX, t.y, offset, bulletSpeed);  // 右斜弹幕
+        }
+
+        player.lastShotTime = currentTime;
+    }
+}
+
+void Simulation::updateEnemies() {
+    PROFILE_ZONE("updateEnemies");
+    uint32_t currentTime = simTime();
+    std::vector<Transform>& transforms = enemies.column<Transform>();
+    const std::vector<Velocity>& velocities = enemies.column<Velocity>();
+    for (int e = 0; e < enemies.size(); ++e) {
+        transforms[e].x += velocities[e].dx;
+        transforms[e].y += velocities[e].dy;
+    }
+
+    // 敌人随机发射子弹
+    const std::vector<Hitbox>& hitboxes = enemies.column<Hitbox>();
+    std::vector<Weapon>& weapons = enemies.column<Weapon>();
+    for (int e = 0; e < enemies.size(); ++e) {
+        Weapon& weapon = weapons[e];
+        if (currentTime - weapon.lastShotTime > weapon.interval) {
+            Fixed bulletX = transforms[e].x + toFixed(hitboxes[e].w / 2 - 2);
+            Fixed bulletY = transforms[e].y + toFixed(hitboxes[e].h);
+            Fixed bulletSpeed = perTick(enemyBulletSpeed);
+            enemyBullets.spawn(bulletX, bulletY, 0, bulletSpeed);
+
+            // 散射：其余子弹按 -1, +1, -2, +2 ... 倍 ENEMY_SPREAD_STEP 的横向速度依次散开
+            for (int i = 1; i < enemySpread; ++i) {
+                Fixed offset = perTick(ENEMY_SPREAD_STEP * ((i + 1) / 2));
+                enemyBullets.spawn(bulletX, bulletY, (i & 1) ? -offset : offset, bulletSpeed);
+            }
+            weapon.lastShotTime = currentTime;
+        }
+    }
+}
+
+// 增加击杀计数器，每击杀20个敌人增加额外弹幕
+void Simulation::increaseKillCount() {
+    player.enemyKillCount++; // 先增加击杀计数
+
+    // 每20个敌人增加一对弹幕，最多增加两对
+    if (player.enemyKillCount % 20 == 0 && player.extraBulletCount < 2) {
+        player.extraBulletCount++;
+    }
+
+    // 每击杀一个敌人，减少射击间隔，最小不低于100毫秒
+    player.shotInterval = std::max<uint32_t>(player.shotInterval - 5, 100U);
+}
+
+void Simulation::damagePlayer() {
+    if (invulnerable) {
+        return;
+    }
+    player.lives--;         // 减少玩家生命值
+    if (player.lives <= 0) {
+        gameOver = true;    // 切换到游戏结束状态
+    }
+}
+
+namespace {
+
+// 每次移动一块子弹后立即检测这一块，数据仍在缓存中；块大小是 32 的倍数，命中掩码按 32 位存放
+const int BULLET_BLOCK = 256;
+
+// 玩家子弹只与敌人碰撞：逐个在网格中找下标最小的命中敌人
+struct HitsEnemies {
+    static void testBlock(const Simulation& sim, const BulletPool& pool, int begin, int end, FrameVector<BulletHit>& hits) {
+        for (int i = begin; i < end; ++i) {
+            if (pool.dead[i]) {
+                continue;
+            }
+            Rect bulletRect = pool.rect(i);
+            int hitEnemy = -1;
+            sim.enemyGrid.query(bulletRect, [&](int e) {
+                if ((hitEnemy < 0 || e < hitEnemy) && intersects(bulletRect, sim.enemyRect(e))) {
+                    hitEnemy = e;
+                }
+            });
+            if (hitEnemy >= 0) {
+                hits.push_back(BulletHit{ i, hitEnemy });
+            }
+        }
+    }
+};
+
+// 敌人子弹只与玩家碰撞：整块子弹用 SIMD 与玩家矩形比较，得到命中掩码
+struct HitsPlayer {
+    static void testBlock(const Simulation& sim, const BulletPool& pool, int begin, int end, FrameVector<BulletHit>& hits) {
+        uint32_t mask[BULLET_BLOCK / 32];
+        sim.aabbKernel(pool.x.data() + begin, pool.y.data() + begin, end - begin, BulletPool::BULLET_W, BulletPool::BULLET_H, sim.playerRect(), mask);
+        for (int word = 0; word < (end - begin + 31) / 32; ++word) {
+            uint32_t bits = mask[word];
+            while (bits != 0) {
+                int i = begin + word * 32 + lowestBit(bits);
+                bits &= bits - 1;
+                if (!pool.dead[i]) {
+                    hits.push_back(BulletHit{ i, -1 });
+                }
+            }
+        }
+    }
+};
+
+}
+
+template <typename HitPolicy>
+void Simulation::updateBullets(BulletPool& pool, int movedCount, FrameVector<BulletHit>& hits) {
+    // 每颗子弹最多产生一个命中事件，预留后遍历过程中不会再分配
+    // 从推进模拟的线程的 FrameArena 分配，与构造 Simulation 的线程无关
+    hits = FrameVector<BulletHit>(FrameArena::current());
+    hits.reserve(pool.count);
+
+    for (int begin = 0; begin < pool.count; begin += BULLET_BLOCK) {
+        int end = (std::min)(begin + BULLET_BLOCK, pool.count);
+        int moveEnd = (std::min)(end, movedCount);
+        if (begin < moveEnd) {
+            pool.integrate(begin, moveEnd); // 出屏的子弹被标记，不再参与碰撞
+        }
+        HitPolicy::testBlock(*this, pool, begin, end, hits);
+    }
+}
+
+void Simulation::updatePlayerBullets(int movedCount) {
+    PROFILE_ZONE("updatePlayerBullets");
+
+    // 用敌人重建网格，玩家子弹只检测所在格子里的敌人
+    enemyGrid.build(enemies.size(), [&](int e) { return enemyRect(e); });
+
+    updateBullets<HitsEnemies>(playerBullets, movedCount, playerHits);
+}
+
+void Simulation::updateEnemyBullets(int movedCount) {
+    PROFILE_ZONE("updateEnemyBullets");
+    updateBullets<HitsPlayer>(enemyBullets, movedCount, enemyHits);
+}
+
+void Simulation::resolveHits() {
+    PROFILE_ZONE("resolveHits");
+    for (const auto& hit : enemyHits) {
+        enemyBullets.kill(hit.bullet);          // 标记敌人子弹
+        damagePlayer();
+    }
+
+    for (const auto& hit : playerHits) {
+        // 预先找到的敌人已被前面的子弹击毁时，重新查找下标最小的存活敌人
+        int hitEnemy = hit.target;
+        if (enemies.killed(hitEnemy)) {
+            Rect bulletRect = playerBullets.rect(hit.bullet);
+            hitEnemy = -1;
+            enemyGrid.query(bulletRect, [&](int e) {
+                if (!enemies.killed(e) && (hitEnemy < 0 || e < hitEnemy) && intersects(bulletRect, enemyRect(e))) {
+                    hitEnemy = e;
+                }
+            });
+            if (hitEnemy < 0) {
+                continue;
+            }
+        }
+
+        playerBullets.kill(hit.bullet);         // 标记子弹
+        enemies.kill(hitEnemy);                 // 标记敌人
+        score += 100;                           // 增加分数
+        enemyKillCount++;                       // 更新击杀计数
+        increaseKillCount();                    // 检查是否需要增加额外弹幕
+    }
+}
+
+void Simulation::checkPlayerEnemyCollision() {
+    PROFILE_ZONE("checkPlayerEnemyCollision");
+    for (int e = 0; e < enemies.size(); ++e) {
+        if (!enemies.killed(e) && intersects(playerRect(), enemyRect(e))) {
+            enemies.kill(e);                   // 标记敌人
+            damagePlayer();
+        }
+    }
+}
+
+void Simulation::checkEnemyBottomCollision() {
+    PROFILE_ZONE("checkEnemyBottomCollision");
+    for (int e = 0; e < enemies.size(); ++e) {
+        Rect rect = enemyRect(e);
+        if (!enemies.killed(e) && rect.y + rect.h >= SCREEN_HEIGHT) {
+            enemies.kill(e);                   // 标记敌人
+            damagePlayer();                    // 扣除玩家生命值
+        }
+    }
+}
+
+Entity Simulation::createEnemy(int x, int y, uint32_t lastShotTime, uint32_t shootInterval) {
+    Fixed fx = toFixed(x);
+    Fixed fy = toFixed(y);
+    return enemies.create(Transform{ fx, fy, fx, fy }, Hitbox{ 50, 50 }, Velocity{ 0, perTick(ENEMY_SPEED) }, Weapon{ lastShotTime, shootInterval }, Sprite{ SPRITE_ENEMY });
+}
+
+void Simulation::spawnEnemy() {
+    PROFILE_ZONE("spawnEnemy");
+    uint32_t currentTime = simTime();
+    if (currentTime - lastEnemySpawnTime > static_cast<uint32_t>(enemySpawnRate)) {
+        int x = spawnRng.range(0, SCREEN_WIDTH - 50); // 随机生成敌人的 x 坐标
+        uint32_t shootInterval = 1000 + fireRng.below(2000);
+        createEnemy(x, 0, 0, shootInterval); // 在顶部生成新的敌人
+        lastEnemySpawnTime = currentTime; // 更新上一次生成敌人的时间
+
+        // 随着时间推移，逐渐减少敌人生成间隔，加快生成速度
+        if (enemySpawnRate > minSpawnRate) {
+            enemySpawnRate -= 100;
+        }
+    }
+}
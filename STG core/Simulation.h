@@ -0,0 +1,110 @@
+﻿#pragma once
+#include "SimTypes.h"
+#include "BulletPool.h"
+#include "Collide.h"
+#include "FrameArena.h"
+#include "Registry.h"
+#include "SpatialGrid.h"
+#include "Rng.h"
+#include <vector>
+
+// 子弹命中事件：bullet 为子弹在所属子弹池中的下标，target 为被击中的敌人下标，击中玩家时为 -1
+struct BulletHit {
+    int bullet;
+    int target;
+};
+
+// 敌人表：位置、碰撞盒、速度、射击计时和图片各占一列
+typedef EntityTable<Transform, Hitbox, Velocity, Weapon, Sprite> EnemyTable;
+
+// 游戏模拟核心：保存一局游戏的全部状态，通过 step() 逐帧推进，不依赖 SDL
+class Simulation {
+public:
+    // 随机数流编号，每个用途一条独立的流
+    enum RngStream {
+        STREAM_SPAWN = 1,
+        STREAM_FIRE = 2,
+        STREAM_EFFECTS = 3
+    };
+
+    PlayerState player;
+    EnemyTable enemies;
+    BulletPool playerBullets; // 玩家子弹，只与敌人碰撞
+    BulletPool enemyBullets;  // 敌人子弹，只与玩家碰撞
+    SpatialGrid enemyGrid;
+    FrameVector<BulletHit> playerHits; // 本帧玩家子弹的命中事件，从当前线程的 FrameArena 分配，帧末失效
+    FrameVector<BulletHit> enemyHits;  // 本帧敌人子弹的命中事件
+    AabbBatchFunction aabbKernel;      // 敌人子弹与玩家检测使用的批量 AABB 实现，构造时按 CPU 选定
+    int score;
+    int enemySpawnRate;
+    const int minSpawnRate;
+    uint32_t lastEnemySpawnTime;
+    int enemyKillCount;
+    uint64_t tick;       // 已执行的逻辑帧数
+    double clock;        // 模拟时间（秒），只由 step() 的 dt 推进
+    bool gameOver;
+    uint32_t finalGameTime;
+    uint64_t seed;       // 本局种子，相同种子和输入产生完全相同的对局
+    Rng spawnRng;        // 敌人生成位置
+    Rng fireRng;         // 敌人射击间隔
+    Rng effectsRng;      // 留给不影响玩法的表现效果使用
+
+    // 敌人射击参数和无敌开关，供压力测试修改，reset() 不会重置
+    int enemyBulletSpeed; // 敌人子弹的速度（像素每秒）
+    int enemySpread;      // 敌人每次射击的子弹数，多出的子弹向两侧散开
+    bool invulnerable;    // 玩家不会受到伤害
+
+    Simulation();
+
+    // 开始新的一局
+    void reset(uint64_t newSeed);
+
+    // 推进一个逻辑帧。速度以像素每秒给出，按 TICK_RATE 换算为每帧位移，dt 只用于推进射击和生成计时器
+    // 本帧的临时数据从当前线程的 FrameArena 分配；调用方在 step() 返回后 reset() 该线程的 FrameArena
+    void step(const Input& input, double dt);
+
+    // 模拟时间（毫秒）
+    uint32_t simTime() const {
+        return static_cast<uint32_t>(clock * 1000.0 + 0.5);
+    }
+
+    // 对局状态的哈希，用于校验录像回放是否与录制时完全一致
+    uint32_t stateHash() const;
+
+    // 玩家的包围盒（像素）
+    Rect playerRect() const {
+        return rectOf(player.transform, player.hitbox);
+    }
+
+    // 第 row 个敌人的包围盒
+    Rect enemyRect(int row) const {
+        return rectOf(enemies.column<Transform>()[row], enemies.column<Hitbox>()[row]);
+    }
+
+    // 在指定的像素位置创建一个敌人，lastShotTime 和 shootInterval 为射击计时
+    Entity createEnemy(int x, int y, uint32_t lastShotTime, uint32_t shootInterval);
+
+    void handlePlayerInput(const Input& input);
+    void updateEnemies();
+
+    // 每个阵营的子弹一次遍历完成移动、出屏剔除和碰撞检测，命中只记录到对应的事件缓冲区
+    // 下标小于 movedCount 的子弹本帧需要移动，之后的是敌人刚发射的子弹
+    void updatePlayerBullets(int movedCount);
+    void updateEnemyBullets(int movedCount);
+
+    // 按子弹顺序结算命中事件，只标记被击毁的敌人和子弹
+    void resolveHits();
+
+    // 以下检测跳过本帧已被标记的敌人，销毁统一在 step() 末尾完成
+    void checkPlayerEnemyCollision();
+    void checkEnemyBottomCollision();
+    void spawnEnemy();
+
+private:
+    // HitPolicy 在编译期决定子弹能击中谁，内层循环没有阵营判断
+    template <typename HitPolicy>
+    void updateBullets(BulletPool& pool, int movedCount, FrameVector<BulletHit>& hits);
+
+    void increaseKillCount();
+    void damagePlayer();
+};
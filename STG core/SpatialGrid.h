@@ -0,0 +1,90 @@
+﻿#pragma once
+#include "SimTypes.h"
+#include <algorithm>
+#include <vector>
+
+// 均匀网格粗检测：每帧重建，格子内只保存物体下标
+class SpatialGrid {
+public:
+    int cellSize;
+    int cols;
+    int rows;
+    std::vector<int> cellStart;  // 每个格子在 cellItems 中的起始位置，长度为格子数 + 1
+    std::vector<int> cellItems;
+
+    SpatialGrid(int width, int height, int size)
+        : cellSize(size),
+        cols((width + size - 1) / size),
+        rows((height + size - 1) / size) {
+        cellStart.resize(cols * rows + 1);
+        cellFill.resize(cols * rows);
+    }
+
+    // 预留 count 个物体的格子列表，物体不大于格子时最多跨 4 个格子
+    void reserve(int count) {
+        cellItems.reserve(count * 4);
+    }
+
+    // 计数排序重建网格，rectOf(i) 返回第 i 个物体的包围盒
+    template <typename RectOf>
+    void build(int count, RectOf rectOf) {
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+        for (int i = 0; i < count; ++i) {
+            int x0, y0, x1, y1;
+            cellRange(rectOf(i), x0, y0, x1, y1);
+            for (int cy = y0; cy <= y1; ++cy) {
+                for (int cx = x0; cx <= x1; ++cx) {
+                    cellStart[cy * cols + cx + 1]++;
+                }
+            }
+        }
+        for (int c = 0; c < cols * rows; ++c) {
+            cellStart[c + 1] += cellStart[c];
+        }
+        if (static_cast<int>(cellItems.size()) < cellStart[cols * rows]) {
+            cellItems.resize(cellStart[cols * rows]);
+        }
+        std::copy(cellStart.begin(), cellStart.end() - 1, cellFill.begin());
+        for (int i = 0; i < count; ++i) {
+            int x0, y0, x1, y1;
+            cellRange(rectOf(i), x0, y0, x1, y1);
+            for (int cy = y0; cy <= y1; ++cy) {
+                for (int cx = x0; cx <= x1; ++cx) {
+                    cellItems[cellFill[cy * cols + cx]++] = i;
+                }
+            }
+        }
+    }
+
+    // 对与 rect 重叠的每个格子中的物体调用 fn(i)，同一物体可能被访问多次
+    template <typename Fn>
+    void query(const Rect& rect, Fn fn) const {
+        int x0, y0, x1, y1;
+        cellRange(rect, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                int cell = cy * cols + cx;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    fn(cellItems[k]);
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<int> cellFill;
+
+    // 屏幕外的部分归入边缘格子，精确判定交给调用者
+    void cellRange(const Rect& r, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = clampCell(r.x, cols);
+        y0 = clampCell(r.y, rows);
+        x1 = clampCell(r.x + r.w - 1, cols);
+        y1 = clampCell(r.y + r.h - 1, rows);
+    }
+
+    int clampCell(int v, int n) const {
+        if (v < 0) return 0;
+        int c = v / cellSize;
+        return c < n ? c : n - 1;
+    }
+};
@@ -0,0 +1,120 @@
+﻿#include "Stress.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// 帧时间缓冲按每秒这么多帧预留；压力测试不限帧率，但帧率超过它时等级本身已经没有意义
+const int RESERVED_FRAME_RATE = 1000;
+
+}
+
+bool loadStressScenario(const std::string& path, std::vector<StressStep>& steps) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Unable to open scenario " << path << "!" << std::endl;
+        return false;
+    }
+    steps.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        StressStep step;
+        if (!(fields >> step.enemies >> step.fireInterval >> step.spread >> step.bulletSpeed >> step.seconds) ||
+            step.enemies < 0 || step.fireInterval <= 0 || step.spread <= 0 || step.bulletSpeed <= 0 || step.seconds <= 0.0) {
+            std::cerr << "Invalid scenario line " << lineNumber << " in " << path << "!" << std::endl;
+            return false;
+        }
+        steps.push_back(step);
+    }
+    if (steps.empty()) {
+        std::cerr << "Scenario " << path << " has no steps!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void StressRun::apply(Simulation& sim) {
+    if (!active()) {
+        return;
+    }
+    const StressStep& step = steps[current];
+    sim.enemyBulletSpeed = step.bulletSpeed;
+    sim.enemySpread = step.spread;
+    sim.invulnerable = true;
+
+    // 敌人数量由压力测试控制，不再按时间生成
+    uint32_t now = sim.simTime();
+    sim.lastEnemySpawnTime = now;
+    uint32_t interval = static_cast<uint32_t>(step.fireInterval);
+    for (auto& weapon : sim.enemies.column<Weapon>()) {
+        weapon.interval = interval;
+    }
+
+    // 补充的敌人出现在屏幕上半部分，射击时刻错开
+    while (sim.enemies.size() < step.enemies) {
+        int x = sim.spawnRng.range(0, SCREEN_WIDTH - 50);
+        int y = sim.spawnRng.range(0, SCREEN_HEIGHT / 2);
+        sim.createEnemy(x, y, now - sim.fireRng.below(interval), interval);
+    }
+}
+
+void StressRun::frame(double seconds, int bulletCount, std::ostream& out) {
+    if (!active()) {
+        return;
+    }
+    const StressStep& step = steps[current];
+    elapsed += seconds;
+
+    // 第一帧时按最长等级的统计时长一次性预留，测量期间不再分配
+    if (frameTimes.capacity() == 0) {
+        double longest = 0.0;
+        for (const StressStep& s : steps) {
+            longest = (std::max)(longest, s.seconds);
+        }
+        frameTimes.reserve(static_cast<size_t>(longest / 2 * RESERVED_FRAME_RATE) + 1);
+    }
+
+    // 前半段等待子弹密度稳定，只统计后半段
+    if (elapsed >= step.seconds / 2) {
+        frameTimes.push_back(seconds);
+        bulletSum += bulletCount;
+    }
+    if (elapsed < step.seconds) {
+        return;
+    }
+
+    double total = 0.0;
+    for (double t : frameTimes) {
+        total += t;
+    }
+    size_t frames = frameTimes.size();
+    double fps = total > 0.0 ? frames / total : 0.0;
+    double p99 = 0.0;
+    if (frames > 0) {
+        size_t rank = (std::min)(frames - 1, frames * 99 / 100);
+        std::nth_element(frameTimes.begin(), frameTimes.begin() + rank, frameTimes.end());
+        p99 = frameTimes[rank];
+    }
+    out << "Step " << current + 1 << "/" << steps.size()
+        << ": enemies " << step.enemies
+        << ", fire interval " << step.fireInterval << "ms"
+        << ", spread " << step.spread
+        << ", bullet speed " << step.bulletSpeed << "px/s"
+        << " | bullets " << (frames > 0 ? bulletSum / frames : 0)
+        << ", FPS " << fps
+        << ", p99 " << p99 * 1000.0 << "ms" << std::endl;
+
+    current++;
+    elapsed = 0.0;
+    frameTimes.clear();
+    bulletSum = 0;
+}
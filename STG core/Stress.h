@@ -0,0 +1,41 @@
+﻿#pragma once
+#include "Simulation.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 压力测试的一个密度等级
+struct StressStep {
+    int enemies;       // 同时存在的敌人数
+    int fireInterval;  // 每个敌人的射击间隔（毫秒）
+    int spread;        // 每次射击的子弹数
+    int bulletSpeed;   // 敌人子弹的速度（像素每秒）
+    double seconds;    // 持续时间
+};
+
+// 读取场景文件：每行一个密度等级，依次为 敌人数 射击间隔 散射子弹数 子弹速度 持续秒数，# 开头的行为注释
+bool loadStressScenario(const std::string& path, std::vector<StressStep>& steps);
+
+// 按密度等级逐级运行，统计每一级的持续帧率和 p99 帧时间
+class StressRun {
+public:
+    std::vector<StressStep> steps;
+
+    StressRun() : current(0), elapsed(0.0), bulletSum(0) {}
+
+    bool active() const {
+        return current < steps.size();
+    }
+
+    // 每个逻辑帧调用：补足敌人数量并设置射击参数
+    void apply(Simulation& sim);
+
+    // 每个渲染帧调用，当前等级结束时把统计结果写到 out 并进入下一级
+    void frame(double seconds, int bulletCount, std::ostream& out);
+
+private:
+    size_t current;
+    double elapsed;
+    std::vector<double> frameTimes; // 当前等级后半段的帧时间
+    uint64_t bulletSum;
+};
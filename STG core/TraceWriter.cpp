@@ -0,0 +1,94 @@
+﻿#include "TraceWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+TraceWriter::TraceWriter() : busy(false), stopping(false) {
+    worker = std::thread(&TraceWriter::run, this);
+}
+
+TraceWriter::~TraceWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void TraceWriter::capture(const std::string& path, double seconds) {
+    Profiler& profiler = Profiler::instance();
+    Job job;
+    job.path = path;
+    job.frequency = profiler.ticksPerSecond();
+    uint64_t window = static_cast<uint64_t>(seconds * job.frequency);
+    uint64_t now = profiler.now();
+    profiler.capture(now > window ? now - window : 0, job.events);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void TraceWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return jobs.empty() && !busy; });
+}
+
+void TraceWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            break; // 退出前先写完剩余的任务
+        }
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+
+        write(job);
+
+        lock.lock();
+        busy = false;
+        if (jobs.empty()) {
+            idle.notify_all();
+        }
+    }
+}
+
+bool TraceWriter::write(const Job& job) {
+    PROFILE_ZONE("writeTrace");
+    FILE* file = std::fopen(job.path.c_str(), "w");
+    if (file == nullptr) {
+        std::cerr << "Unable to write trace " << job.path << "!" << std::endl;
+        return false;
+    }
+
+    // 时间戳以微秒为单位，从最早的区间开始计时
+    uint64_t base = 0;
+    if (!job.events.empty()) {
+        base = std::min_element(job.events.begin(), job.events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+            return a.start < b.start;
+        })->start;
+    }
+    double microsecondsPerTick = 1000000.0 / job.frequency;
+
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < job.events.size(); ++i) {
+        const ProfileEvent& event = job.events[i];
+        std::fprintf(file, "{\"name\":\"%s\",\"cat\":\"stg\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"allocs\":%u}},\n",
+            event.name, (event.start - base) * microsecondsPerTick, (event.end - event.start) * microsecondsPerTick, event.thread, event.allocations);
+    }
+    std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Bullet Hell Game\"}}\n");
+    std::fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    bool written = std::ferror(file) == 0;
+    std::fclose(file);
+    if (!written) {
+        std::cerr << "Unable to write trace " << job.path << "!" << std::endl;
+    }
+    return written;
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include "Profiler.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 把分析区间导出为 Chrome trace_event 格式的 JSON，可以用 chrome://tracing 或 Perfetto 打开
+// 调用方只复制缓冲区里的事件，格式化和写文件都在后台线程完成，导出本身不会造成卡顿
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter();
+
+    // 导出最近 seconds 秒内结束的区间到 path，立即返回
+    void capture(const std::string& path, double seconds);
+
+    // 等待已提交的文件全部写完
+    void flush();
+
+private:
+    struct Job {
+        std::string path;
+        std::vector<ProfileEvent> events;
+        uint64_t frequency;
+    };
+
+    void run();
+    bool write(const Job& job);
+
+    std::mutex mutex;
+    std::condition_variable wake;  // 有新任务或需要退出
+    std::condition_variable idle;  // 任务全部完成
+    std::deque<Job> jobs;
+    bool busy;
+    bool stopping;
+    std::thread worker;
+};
@@ -0,0 +1,146 @@
+﻿#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <vector>
+
+// 字形图集：启动时把 ASCII 可见字符渲染进一张纹理，之后任意字符串都用图集中的四边形拼出
+class GlyphAtlas {
+public:
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 126;
+    static const int ATLAS_WIDTH = 512;
+
+    struct Glyph {
+        SDL_Rect src;  // 在图集中的位置，宽度即前进距离
+    };
+
+    SDL_Texture* texture;
+    int atlasHeight;
+    int lineHeight;
+    Glyph glyphs[LAST_CHAR - FIRST_CHAR + 1];
+
+    explicit GlyphAtlas(int maxChars = 256) : texture(nullptr), atlasHeight(0), lineHeight(0) {
+        vertices.reserve(maxChars * 4);
+        indices.reserve(maxChars * 6);
+    }
+
+    bool build(SDL_Renderer* renderer, TTF_Font* font) {
+        SDL_Color white = { 255, 255, 255, 255 };
+        SDL_Surface* glyphSurfaces[LAST_CHAR - FIRST_CHAR + 1] = {};
+        lineHeight = TTF_FontHeight(font);
+
+        // 先渲染所有字形，行高取最高的字形
+        int rowHeight = lineHeight;
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+            SDL_Surface* glyph = TTF_RenderGlyph_Blended(font, static_cast<Uint16>(c), white);
+            if (glyph == nullptr) {
+                std::cerr << "Unable to render glyph! SDL_ttf Error: " << TTF_GetError() << std::endl;
+                freeSurfaces(glyphSurfaces);
+                return false;
+            }
+            glyphSurfaces[c - FIRST_CHAR] = glyph;
+            if (glyph->h > rowHeight) {
+                rowHeight = glyph->h;
+            }
+        }
+
+        // 按行排布
+        int penX = 0;
+        int penY = 0;
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+            SDL_Surface* glyph = glyphSurfaces[c - FIRST_CHAR];
+            if (penX + glyph->w > ATLAS_WIDTH) {
+                penX = 0;
+                penY += rowHeight;
+            }
+            glyphs[c - FIRST_CHAR].src = { penX, penY, glyph->w, glyph->h };
+            penX += glyph->w;
+        }
+        atlasHeight = penY + rowHeight;
+
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+        if (atlas == nullptr) {
+            std::cerr << "Unable to create glyph atlas! SDL Error: " << SDL_GetError() << std::endl;
+            freeSurfaces(glyphSurfaces);
+            return false;
+        }
+        SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 255, 255, 255, 0));
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+            SDL_Surface* glyph = glyphSurfaces[c - FIRST_CHAR];
+            SDL_SetSurfaceBlendMode(glyph, SDL_BLENDMODE_NONE); // 直接拷贝 alpha
+            SDL_BlitSurface(glyph, nullptr, atlas, &glyphs[c - FIRST_CHAR].src);
+        }
+        freeSurfaces(glyphSurfaces);
+
+        texture = SDL_CreateTextureFromSurface(renderer, atlas);
+        SDL_FreeSurface(atlas);
+        if (texture == nullptr) {
+            std::cerr << "Unable to create glyph atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return true;
+    }
+
+    // 把一行文字加入当前批次，颜色通过顶点色调制
+    void addText(const char* text, int x, int y, SDL_Color color) {
+        float invW = 1.0f / ATLAS_WIDTH;
+        float invH = 1.0f / atlasHeight;
+        float penX = static_cast<float>(x);
+        float top = static_cast<float>(y);
+        for (const char* p = text; *p; ++p) {
+            const SDL_Rect& src = glyphFor(*p).src;
+            int base = static_cast<int>(vertices.size());
+            float u0 = src.x * invW;
+            float v0 = src.y * invH;
+            float u1 = (src.x + src.w) * invW;
+            float v1 = (src.y + src.h) * invH;
+            vertices.push_back({ { penX, top }, color, { u0, v0 } });
+            vertices.push_back({ { penX + src.w, top }, color, { u1, v0 } });
+            vertices.push_back({ { penX + src.w, top + src.h }, color, { u1, v1 } });
+            vertices.push_back({ { penX, top + src.h }, color, { u0, v1 } });
+            indices.push_back(base);
+            indices.push_back(base + 1);
+            indices.push_back(base + 2);
+            indices.push_back(base);
+            indices.push_back(base + 2);
+            indices.push_back(base + 3);
+            penX += src.w;
+        }
+    }
+
+    // 一次几何提交画出本批次所有文字
+    void flush(SDL_Renderer* renderer) {
+        if (!vertices.empty() && texture != nullptr) {
+            SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+                indices.data(), static_cast<int>(indices.size()));
+        }
+        vertices.clear();
+        indices.clear();
+    }
+
+    void destroy() {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+private:
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    // 图集外的字符用 '?' 代替
+    const Glyph& glyphFor(char c) const {
+        int code = static_cast<unsigned char>(c);
+        if (code < FIRST_CHAR || code > LAST_CHAR) {
+            code = '?';
+        }
+        return glyphs[code - FIRST_CHAR];
+    }
+
+    static void freeSurfaces(SDL_Surface** surfaces) {
+        for (int i = 0; i <= LAST_CHAR - FIRST_CHAR; ++i) {
+            SDL_FreeSurface(surfaces[i]);
+        }
+    }
+};
@@ -0,0 +1,131 @@
+﻿#pragma once
+#include <SDL.h>
+#include <SDL_image.h>
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 精灵图集：加载时把所有精灵缩放到绘制尺寸并打包进一张纹理
+class SpriteAtlas {
+public:
+    static const int ATLAS_WIDTH = 1024;
+    static const int PADDING = 1; // 精灵之间留空，避免线性过滤时串色
+
+    SDL_Texture* texture;
+    int width;
+    int height;
+    std::vector<SDL_Rect> sprites; // 每个精灵在图集中的位置，下标即精灵编号
+
+    SpriteAtlas() : texture(nullptr), width(ATLAS_WIDTH), height(0) {}
+
+    // 从文件加载图片并缩放到 w x h，返回精灵编号，失败返回 -1
+    int addImage(const std::string& path, int w, int h) {
+        PROFILE_ZONE("SpriteAtlas::addImage");
+        SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+        if (loadedSurface == nullptr) {
+            std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+            return -1;
+        }
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loadedSurface);
+        if (converted == nullptr) {
+            std::cerr << "Unable to convert image " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+            return -1;
+        }
+        SDL_Surface* scaled = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+        if (scaled == nullptr || SDL_SoftStretchLinear(converted, nullptr, scaled, nullptr) < 0) {
+            std::cerr << "Unable to scale image " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+            SDL_FreeSurface(converted);
+            SDL_FreeSurface(scaled);
+            return -1;
+        }
+        SDL_FreeSurface(converted);
+        return addSurface(scaled);
+    }
+
+    // 纯色矩形精灵，用于子弹
+    int addSolid(int w, int h, SDL_Color color) {
+        SDL_Surface* solid = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+        if (solid == nullptr) {
+            std::cerr << "Unable to create sprite surface! SDL Error: " << SDL_GetError() << std::endl;
+            return -1;
+        }
+        SDL_FillRect(solid, nullptr, SDL_MapRGBA(solid->format, color.r, color.g, color.b, color.a));
+        return addSurface(solid);
+    }
+
+    // 按高度从大到小逐行打包，生成图集纹理后释放所有表面
+    bool build(SDL_Renderer* renderer) {
+        PROFILE_ZONE("SpriteAtlas::build");
+        std::vector<int> order(pending.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<int>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return pending[a]->h > pending[b]->h; });
+
+        sprites.assign(pending.size(), SDL_Rect{ 0, 0, 0, 0 });
+        int penX = 0;
+        int penY = 0;
+        int rowHeight = 0;
+        for (int id : order) {
+            SDL_Surface* s = pending[id];
+            if (penX + s->w > width) {
+                penX = 0;
+                penY += rowHeight + PADDING;
+                rowHeight = 0;
+            }
+            sprites[id] = { penX, penY, s->w, s->h };
+            penX += s->w + PADDING;
+            rowHeight = (std::max)(rowHeight, s->h);
+        }
+        height = 1;
+        while (height < penY + rowHeight) {
+            height *= 2;
+        }
+
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (atlas == nullptr) {
+            std::cerr << "Unable to create sprite atlas! SDL Error: " << SDL_GetError() << std::endl;
+            freePending();
+            return false;
+        }
+        SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 0, 0, 0, 0));
+        for (size_t id = 0; id < pending.size(); ++id) {
+            SDL_SetSurfaceBlendMode(pending[id], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(pending[id], nullptr, atlas, &sprites[id]);
+        }
+        freePending();
+
+        texture = SDL_CreateTextureFromSurface(renderer, atlas);
+        SDL_FreeSurface(atlas);
+        if (texture == nullptr) {
+            std::cerr << "Unable to create sprite atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return true;
+    }
+
+    void destroy() {
+        freePending();
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+private:
+    std::vector<SDL_Surface*> pending; // 等待打包的表面
+
+    int addSurface(SDL_Surface* surface) {
+        pending.push_back(surface);
+        return static_cast<int>(pending.size()) - 1;
+    }
+
+    void freePending() {
+        for (SDL_Surface* s : pending) {
+            SDL_FreeSurface(s);
+        }
+        pending.clear();
+    }
+};
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <SDL.h>
+#include <vector>
+
+// 精灵批处理：收集同一图集上的所有四边形，一次 SDL_RenderGeometry 提交
+class SpriteBatch {
+public:
+    SpriteBatch() : texture(nullptr), invW(0.0f), invH(0.0f) {}
+
+    // 预留 maxSprites 个四边形的空间，每帧不超过这个数量时不会重新分配
+    void reserve(int maxSprites) {
+        vertices.reserve(maxSprites * 4);
+        indices.reserve(maxSprites * 6);
+    }
+
+    void begin(SDL_Texture* tex, int atlasWidth, int atlasHeight) {
+        texture = tex;
+        invW = 1.0f / atlasWidth;
+        invH = 1.0f / atlasHeight;
+        vertices.clear();
+        indices.clear();
+    }
+
+    void add(const SDL_Rect& src, const SDL_Rect& dst) {
+        SDL_Color white = { 255, 255, 255, 255 };
+        int base = static_cast<int>(vertices.size());
+        float x0 = static_cast<float>(dst.x);
+        float y0 = static_cast<float>(dst.y);
+        float x1 = static_cast<float>(dst.x + dst.w);
+        float y1 = static_cast<float>(dst.y + dst.h);
+        float u0 = src.x * invW;
+        float v0 = src.y * invH;
+        float u1 = (src.x + src.w) * invW;
+        float v1 = (src.y + src.h) * invH;
+        vertices.push_back({ { x0, y0 }, white, { u0, v0 } });
+        vertices.push_back({ { x1, y0 }, white, { u1, v0 } });
+        vertices.push_back({ { x1, y1 }, white, { u1, v1 } });
+        vertices.push_back({ { x0, y1 }, white, { u0, v1 } });
+        indices.push_back(base);
+        indices.push_back(base + 1);
+        indices.push_back(base + 2);
+        indices.push_back(base);
+        indices.push_back(base + 2);
+        indices.push_back(base + 3);
+    }
+
+    // 返回本次提交的绘制调用数
+    int flush(SDL_Renderer* renderer) {
+        if (vertices.empty() || texture == nullptr) {
+            return 0;
+        }
+        SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+            indices.data(), static_cast<int>(indices.size()));
+        vertices.clear();
+        indices.clear();
+        return 1;
+    }
+
+private:
+    SDL_Texture* texture;
+    float invW;
+    float invH;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
@@ -0,0 +1,107 @@
+﻿#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "Profiler.h"
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// 文字缓存：字体按字号只打开一次，渲染好的文字纹理按 (内容, 字号, 颜色) 缓存，超出容量时淘汰最久未用的
+class TextCache {
+public:
+    struct Entry {
+        Uint64 style;
+        std::string text;
+        SDL_Texture* texture;
+        int w;
+        int h;
+    };
+
+    TextCache(const std::string& path, size_t cap) : fontPath(path), capacity(cap) {}
+
+    ~TextCache() {
+        clear();
+    }
+
+    TTF_Font* getFont(int fontSize) {
+        auto it = fonts.find(fontSize);
+        if (it != fonts.end()) {
+            return it->second;
+        }
+        TTF_Font* font = TTF_OpenFont(fontPath.c_str(), fontSize);
+        if (font == nullptr) {
+            std::cerr << "Failed to load font! TTF_Error: " << TTF_GetError() << std::endl;
+            return nullptr;
+        }
+        fonts[fontSize] = font;
+        return font;
+    }
+
+    // 命中时直接返回纹理，未命中时渲染并放入缓存
+    const Entry* getText(SDL_Renderer* renderer, const std::string& message, int fontSize, SDL_Color color) {
+        Uint64 style = (static_cast<Uint64>(fontSize) << 32) |
+            (static_cast<Uint64>(color.r) << 24) | (static_cast<Uint64>(color.g) << 16) |
+            (static_cast<Uint64>(color.b) << 8) | color.a;
+
+        auto& styleIndex = index[style];
+        auto found = styleIndex.find(message);
+        if (found != styleIndex.end()) {
+            lru.splice(lru.begin(), lru, found->second); // 移到最近使用的位置
+            return &*found->second;
+        }
+
+        PROFILE_ZONE("TextCache::render");
+        TTF_Font* font = getFont(fontSize);
+        if (font == nullptr) {
+            return nullptr;
+        }
+        SDL_Surface* textSurface = TTF_RenderText_Solid(font, message.c_str(), color);
+        if (textSurface == nullptr) {
+            std::cerr << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
+            return nullptr;
+        }
+        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        Entry entry{ style, message, textTexture, textSurface->w, textSurface->h };
+        SDL_FreeSurface(textSurface);
+        if (textTexture == nullptr) {
+            std::cerr << "Unable to create text texture! SDL Error: " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+
+        if (lru.size() >= capacity) {
+            evictOldest();
+        }
+        lru.push_front(entry);
+        styleIndex[message] = lru.begin();
+        return &lru.front();
+    }
+
+    // 释放所有纹理和字体，需在销毁渲染器和 TTF_Quit 之前调用
+    void clear() {
+        for (auto& entry : lru) {
+            SDL_DestroyTexture(entry.texture);
+        }
+        lru.clear();
+        index.clear();
+        for (auto& font : fonts) {
+            TTF_CloseFont(font.second);
+        }
+        fonts.clear();
+    }
+
+private:
+    std::string fontPath;
+    size_t capacity;
+    std::map<int, TTF_Font*> fonts;
+    std::list<Entry> lru;  // 表头为最近使用
+    std::unordered_map<Uint64, std::unordered_map<std::string, std::list<Entry>::iterator>> index;
+
+    void evictOldest() {
+        Entry& oldest = lru.back();
+        index[oldest.style].erase(oldest.text);
+        SDL_DestroyTexture(oldest.texture);
+        lru.pop_back();
+    }
+};
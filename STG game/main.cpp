@@ -7,124 +7,66 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <cstring>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <algorithm>
+#include "Simulation.h"
+#include "Replay.h"
+#include "Stress.h"
+#include "FrameStats.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "TraceWriter.h"
+#include "TextCache.h"
+#include "GlyphAtlas.h"
+#include "SpriteAtlas.h"
+#include "SpriteBatch.h"
+
+const int TEXT_CACHE_SIZE = 64; // 缓存的文字纹理数量上限
+const int HUD_FONT_SIZE = 24;
+const int FIXED_SPRITES = 1; // 子弹和敌人以外每帧批处理的精灵：玩家
+const int STRESS_MAX_BULLETS = 1 << 17; // 压力测试时的子弹池容量
+const char* const FRAME_STATS_PATH = "frame_stats.txt"; // 每局结束时追加帧时间统计
+#ifdef NDEBUG
+const char* const BUILD_CONFIG = "Release";
+#else
+const char* const BUILD_CONFIG = "Debug";
+#endif
+const double FRAME_BUDGET_SECONDS = 1.5 / TICK_RATE; // 超过一个半逻辑帧说明已经错过了垂直同步
+const double TRACE_SECONDS = 5.0;  // 导出的时间线长度
+const Uint32 TRACE_COOLDOWN = 10000; // 两次自动导出的最小间隔（毫秒）
+
+// 在两个逻辑帧之间插值，alpha 为当前时刻所处的比例（定点数）；定点数位置只在绘制时转换为像素
+SDL_Rect lerpRect(const Transform& transform, const Hitbox& hitbox, Fixed alpha) {
+    Rect r = interpolateRect(transform, hitbox, alpha);
+    return SDL_Rect{ r.x, r.y, r.w, r.h };
+}
 
-const int SCREEN_WIDTH = 800;
-const int SCREEN_HEIGHT = 600;
-
-class GameObject {
-public:
-    SDL_Rect rect;
-    SDL_Texture* texture;
-
-    GameObject(int x, int y, int w, int h, SDL_Texture* tex) : rect{ x, y, w, h }, texture(tex) {}
-    virtual void update() {}
-    virtual void render(SDL_Renderer* renderer) {
-        if (texture) {
-            SDL_RenderCopy(renderer, texture, nullptr, &rect);
-        }
-    }
-};
-
-class Bullet : public GameObject {
-public:
-    int speedY;
-    int speedX; // ˮƽٶ
-    bool isPlayerBullet;
-
-    Bullet(int x, int y, int spdY, bool isPlayer, int spdX = 0)
-        : GameObject(x, y, 5, 10, nullptr), speedY(spdY), speedX(spdX), isPlayerBullet(isPlayer) {}
-
-    void update() override {
-        rect.y += speedY;
-        rect.x += speedX; // ˮƽλ
-    }
-
-    void render(SDL_Renderer* renderer) override {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderFillRect(renderer, &rect);
-    }
-};
-
-
-class Player : public GameObject {
-public:
-    int lives;
-    Uint32 lastShotTime;
-    Uint32 shotInterval; //  shotInterval ΪͨԱ
-    int extraBulletCount = 0; // ⵯĻ
-    int enemyKillCount = 0;   // ɱ˵ļ
-
-    Player(int x, int y, int w, int h, SDL_Texture* tex, int lv)
-        : GameObject(x, y, w, h, tex), lives(lv), lastShotTime(0), shotInterval(300) {}
-
-    void handleInput(const Uint8* currentKeyStates, std::vector<Bullet>& bullets) {
-        int moveX = 0;
-        int moveY = 0;
-        if (currentKeyStates[SDL_SCANCODE_UP]) moveY = -5;
-        if (currentKeyStates[SDL_SCANCODE_DOWN]) moveY = 5;
-        if (currentKeyStates[SDL_SCANCODE_LEFT]) moveX = -5;
-        if (currentKeyStates[SDL_SCANCODE_RIGHT]) moveX = 5;
-
-        rect.x += moveX;
-        rect.y += moveY;
-
-        if (rect.y < 0) rect.y = 0;
-        if (rect.y + rect.h > SCREEN_HEIGHT) rect.y = SCREEN_HEIGHT - rect.h;
-        if (rect.x < 0) rect.x = 0;
-        if (rect.x + rect.w > SCREEN_WIDTH) rect.x = SCREEN_WIDTH - rect.w;
-
-        Uint32 currentTime = SDL_GetTicks();
-        if (currentKeyStates[SDL_SCANCODE_SPACE] && currentTime - lastShotTime >= shotInterval) {
-            // Ļ
-            bullets.emplace_back(rect.x + rect.w / 2 - 2, rect.y, -10, true);
-
-            //  extraBulletCount ӶбĻ
-            for (int i = 0; i < extraBulletCount; ++i) {
-                int offset = 5 + (i * 5); // ÿⵯĻƫ
-                bullets.emplace_back(rect.x + rect.w / 2 - 2, rect.y, -10, true, -offset); // бĻ
-                bullets.emplace_back(rect.x + rect.w / 2 - 2, rect.y, -10, true, offset);  // бĻ
-            }
-
-            lastShotTime = currentTime;
-        }
-    }
-
-    // ӻɱÿɱ15ӶⵯĻ
-    void increaseKillCount() {
-        enemyKillCount++; // ӻɱ
-
-        // ÿ20һԵĻ
-        if (enemyKillCount % 20 == 0 && extraBulletCount < 2) {
-            extraBulletCount++;
-        }
-
-        // ÿɱ10ˣС100
-        if (enemyKillCount % 1 == 0) {
-            shotInterval = max(shotInterval - 5, 100U);
-        }
-    }
-};
-
-class Enemy : public GameObject {
-public:
-    Uint32 lastShotTime;
-    Uint32 shootInterval;
-
-    Enemy(int x, int y, int w, int h, SDL_Texture* tex)
-        : GameObject(x, y, w, h, tex), lastShotTime(0) {
-        shootInterval = 1000 + rand() % 2000;
+// 第 session 局（从 1 开始）的录像路径：第一局使用原路径，之后在扩展名前加上局数，例如 run_2.stgr
+std::string sessionRecordPath(const std::string& path, int session) {
+    if (session <= 1) {
+        return path;
     }
-
-    void update() override {
-        rect.y += 2;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = path.size();
     }
+    return path.substr(0, dot) + "_" + std::to_string(session) + path.substr(dot);
+}
 
-    void fireBullet(std::vector<Bullet>& bullets) {
-        bullets.emplace_back(rect.x + rect.w / 2 - 2, rect.y + rect.h, 5, false);
-    }
-};
+// 把本帧的键盘状态转换为模拟输入
+Input inputFromKeys(const Uint8* currentKeyStates) {
+    Input input = { 0 };
+    if (currentKeyStates[SDL_SCANCODE_UP]) input.buttons |= INPUT_UP;
+    if (currentKeyStates[SDL_SCANCODE_DOWN]) input.buttons |= INPUT_DOWN;
+    if (currentKeyStates[SDL_SCANCODE_LEFT]) input.buttons |= INPUT_LEFT;
+    if (currentKeyStates[SDL_SCANCODE_RIGHT]) input.buttons |= INPUT_RIGHT;
+    if (currentKeyStates[SDL_SCANCODE_SPACE]) input.buttons |= INPUT_FIRE;
+    return input;
+}
 
 enum GameState {
     MAIN_MENU,
@@ -138,47 +80,71 @@ public:
 
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Texture* playerTexture;
-    SDL_Texture* enemyTexture;
+    SpriteAtlas spriteAtlas; // 所有精灵共用一张图集纹理
+    SpriteBatch spriteBatch;
+    int kindSprites[SPRITE_KIND_COUNT]; // 实体的 SpriteKind 对应的图集精灵
+    int backgroundSprite;
+    int bulletSprites[2]; // 0 为敌人子弹，1 为玩家子弹
     TTF_Font* font;
-
-    std::vector<Enemy> enemies;
-    std::vector<Bullet> bullets;
-    Player* player;
-    int score;
-    int enemySpawnRate;
-    const int minSpawnRate;
-    Uint32 lastEnemySpawnTime;
-    const int FPS;
-    int frameDelay;
-    Uint32 lastEnemyFireTime;
-    int enemyKillCount;
-    Uint32 gameStartTime;
-    Uint32 finalGameTime;
+    TextCache textCache;
+    GlyphAtlas hudAtlas; // HUD 中频繁变化的数字使用字形图集绘制
+    int drawCalls;     // 本帧提交的绘制调用数
+    int lastDrawCalls; // 上一帧的绘制调用数
+    AllocationCount lastFrameAllocations; // 上一帧的堆分配
+    bool showStats;    // F3 切换渲染统计显示
+    bool showProfiler; // F4 切换性能分析显示
+
+    Simulation sim; // 游戏逻辑全部在模拟核心中，这里只负责显示
+
+    ReplayRecorder recorder;  // 录制每局的输入
+    std::string recordPath;   // 录像保存路径，为空时不录制
+    ReplayPlayer replayPlayer;
+    bool replaying;           // 回放录像而不是读取键盘
+    int recordedSessions;     // 已保存的录像局数，用于区分每局的文件名
+    StressRun stress;         // 压力测试的密度等级和帧时间统计
+    FrameStats frameStats;    // 本局每帧各阶段耗时
+    Uint64 presentTicks;      // 上一次 SDL_RenderPresent 的耗时（计数器单位）
+    bool vsync;               // 渲染器实际启用了垂直同步，否则主循环自己限制帧率
 
     SDL_Rect startButtonRect;
     SDL_Rect quitButtonRect;
     SDL_Rect returnButtonRect;
 
+#if STG_PROFILING
+    TraceWriter traceWriter;
+    Uint32 lastTraceTime; // 上一次自动导出时间线的时刻
+#endif
+
     Game() : gameState(MAIN_MENU),
         window(nullptr),
         renderer(nullptr),
-        playerTexture(nullptr),
-        enemyTexture(nullptr),
+        kindSprites{ -1, -1 },
+        backgroundSprite(-1),
+        bulletSprites{ -1, -1 },
         font(nullptr),
-        player(nullptr), score(0),
-        enemySpawnRate(3000),
-        minSpawnRate(200),
-        lastEnemySpawnTime(0),
-        FPS(60),
-        frameDelay(1000 / FPS),
-        lastEnemyFireTime(0),
-        enemyKillCount(0),
-        gameStartTime(0),
-        finalGameTime(0),
+        textCache("constan.ttf", TEXT_CACHE_SIZE),
+        drawCalls(0),
+        lastDrawCalls(0),
+        lastFrameAllocations{ 0, 0 },
+        showStats(false),
+        showProfiler(false),
+        replaying(false),
+        recordedSessions(0),
+        presentTicks(0),
+        vsync(false),
         startButtonRect{ 350, 250, 100, 50 },
         quitButtonRect{ 350, 350, 100, 50 },
-        returnButtonRect{ 350, 450, 100, 50 } {
+        returnButtonRect{ 350, 450, 100, 50 }
+#if STG_PROFILING
+        , lastTraceTime(0)
+#endif
+    {
+        reserveSprites(ENEMY_CAPACITY);
+    }
+
+    // 按两个子弹池的容量和敌人数量预留精灵批处理，子弹池更换后需要重新调用
+    void reserveSprites(int enemyCount) {
+        spriteBatch.reserve(sim.playerBullets.capacity + sim.enemyBullets.capacity + enemyCount + FIXED_SPRITES);
     }
 
     bool init() {
@@ -187,110 +153,103 @@ public:
             return false;
         }
 
+#if STG_PROFILING
+        Profiler::instance().setClock([]() -> uint64_t { return SDL_GetPerformanceCounter(); }, SDL_GetPerformanceFrequency());
+#endif
+
         window = SDL_CreateWindow("Bullet Hell Game", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
         if (window == nullptr) {
             std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
             return false;
         }
 
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
         if (renderer == nullptr) {
             std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
             return false;
         }
+        // 驱动可能不支持或强制关闭垂直同步，按实际得到的渲染器决定是否需要自己限制帧率
+        SDL_RendererInfo rendererInfo;
+        vsync = SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
 
         if (TTF_Init() == -1) {
             std::cerr << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << std::endl;
             return false;
         }
 
-        font = TTF_OpenFont("constan.ttf", 24);
+        font = textCache.getFont(HUD_FONT_SIZE);
         if (font == nullptr) {
-            std::cerr << "Failed to load font! TTF_Error: " << TTF_GetError() << std::endl;
+            return false;
+        }
+
+        if (!hudAtlas.build(renderer, font)) {
             return false;
         }
 
         return true;
     }
 
-    SDL_Texture* loadTexture(const std::string& path) {
-        SDL_Texture* newTexture = nullptr;
-        SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-        if (loadedSurface == nullptr) {
-            std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        }
-        else {
-            newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-            if (newTexture == nullptr) {
-                std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
-            }
-            SDL_FreeSurface(loadedSurface);
+    // 加载所有精灵并打包成一张图集纹理
+    bool loadTextures() {
+        PROFILE_ZONE("loadTextures");
+        SDL_Color white = { 255, 255, 255, 255 };
+        kindSprites[SPRITE_PLAYER] = spriteAtlas.addImage("player.png", 50, 50);
+        kindSprites[SPRITE_ENEMY] = spriteAtlas.addImage("enemy.png", 50, 50);
+        backgroundSprite = spriteAtlas.addImage("background.png", SCREEN_WIDTH, SCREEN_HEIGHT); // 背景暂未绘制，加载失败不影响游戏
+        bulletSprites[0] = spriteAtlas.addSolid(BulletPool::BULLET_W, BulletPool::BULLET_H, white);
+        bulletSprites[1] = spriteAtlas.addSolid(BulletPool::BULLET_W, BulletPool::BULLET_H, white);
+
+        if (kindSprites[SPRITE_PLAYER] < 0 || kindSprites[SPRITE_ENEMY] < 0 || bulletSprites[0] < 0 || bulletSprites[1] < 0) {
+            spriteAtlas.destroy();
+            return false;
         }
-        return newTexture;
+        return spriteAtlas.build(renderer);
     }
 
     void renderText(const std::string& message, int x, int y, SDL_Color color, bool centered = false, int fontSize = 24) {
-        // ָС
-        TTF_Font* tempFont = TTF_OpenFont("constan.ttf", fontSize);
-        if (tempFont == nullptr) {
-            std::cerr << "Failed to load font! TTF_Error: " << TTF_GetError() << std::endl;
+        PROFILE_ZONE("renderText");
+        // 从缓存取文字纹理，未变化的文字只需一次 SDL_RenderCopy
+        const TextCache::Entry* text = textCache.getText(renderer, message, fontSize, color);
+        if (text == nullptr) {
             return;
         }
 
-        SDL_Surface* textSurface = TTF_RenderText_Solid(tempFont, message.c_str(), color);
-        if (textSurface != nullptr) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-
-            SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
+        SDL_Rect renderQuad = { x, y, text->w, text->h };
 
-            // ҪУ x 
-            if (centered) {
-                renderQuad.x = (SCREEN_WIDTH - textSurface->w) / 2;
-            }
-
-            SDL_RenderCopy(renderer, textTexture, nullptr, &renderQuad);
-
-            SDL_DestroyTexture(textTexture);
-            SDL_FreeSurface(textSurface);
-        }
-        else {
-            std::cerr << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
+        // 如果需要居中，则调整 x 坐标
+        if (centered) {
+            renderQuad.x = (SCREEN_WIDTH - text->w) / 2;
         }
 
-        // رʱ
-        TTF_CloseFont(tempFont);
+        SDL_RenderCopy(renderer, text->texture, nullptr, &renderQuad);
     }
 
     void renderButton(const std::string& message, SDL_Rect& rect, SDL_Color textColor) {
-        // ȾťıȡıĿȺ͸߶
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, message.c_str(), textColor);
-        if (textSurface != nullptr) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-
-            // ðťı߾
+        // 渲染按钮文本，获取文本的宽度和高度
+        const TextCache::Entry* text = textCache.getText(renderer, message, 24, textColor);
+        if (text != nullptr) {
+            // 设置按钮的边距
             int padding = 20;
-            rect.w = textSurface->w + padding * 2;
-            rect.h = textSurface->h + padding * 2;
-            rect.x = (SCREEN_WIDTH - rect.w) / 2;  // аť
+            rect.w = text->w + padding * 2;
+            rect.h = text->h + padding * 2;
+            rect.x = (SCREEN_WIDTH - rect.w) / 2;  // 居中按钮
 
-            // Ⱦť
+            // 渲染按钮背景
             SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
             SDL_RenderFillRect(renderer, &rect);
 
-            // Ⱦť߿
+            // 渲染按钮边框
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
             SDL_RenderDrawRect(renderer, &rect);
 
-            // Ⱦıʹڰť
-            SDL_Rect textRect = { rect.x + padding, rect.y + padding, textSurface->w, textSurface->h };
-            SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-
-            SDL_DestroyTexture(textTexture);
-            SDL_FreeSurface(textSurface);
+            // 渲染文本，使其居中在按钮内
+            SDL_Rect textRect = { rect.x + padding, rect.y + padding, text->w, text->h };
+            SDL_RenderCopy(renderer, text->texture, nullptr, &textRect);
         }
     }
 
     void renderMainMenu() {
+        PROFILE_ZONE("renderMainMenu");
         SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
         SDL_RenderClear(renderer);
 
@@ -298,10 +257,10 @@ public:
         SDL_Color red = { 255, 0, 0, 255 };
 		SDL_Color black = { 0, 0, 0, 0 };
 
-        // ʾϷ
+        // 居中显示游戏标题
         renderText("Bullet Hell Game", 0, 100, red, true,72);
 
-        // ʹ renderButton Ⱦť
+        // 使用 renderButton 函数渲染按钮
         renderButton("Start Game", startButtonRect, black);
         renderButton("Quit Game", quitButtonRect, black);
 
@@ -309,6 +268,7 @@ public:
     }
 
     void renderGameOver() {
+        PROFILE_ZONE("renderGameOver");
         SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
         SDL_RenderClear(renderer);
 
@@ -316,31 +276,113 @@ public:
         SDL_Color red = { 255, 0, 0, 255 };
 		SDL_Color black = { 0, 0, 0, 0 };
 
-        // ʾϷϢ
+        // 居中显示游戏结束信息
         renderText("Game Over", 0, 150, red, true,72);
 
-        // ʾʱɱ
-        renderText("Score: " + std::to_string(score), 0, 250, white, true);
-        renderText("Time: " + std::to_string(finalGameTime) + "s", 0, 300, white, true);
-        renderText("Enemies Killed: " + std::to_string(enemyKillCount), 0, 350, white, true);
+        // 显示分数、时间和杀敌数
+        renderText("Score: " + std::to_string(sim.score), 0, 250, white, true);
+        renderText("Time: " + std::to_string(sim.finalGameTime) + "s", 0, 300, white, true);
+        renderText("Enemies Killed: " + std::to_string(sim.enemyKillCount), 0, 350, white, true);
 
-        // ʾ˵ť
+        // 显示返回主菜单按钮
         renderButton("Return to Main Menu", returnButtonRect, black);
 
         SDL_RenderPresent(renderer);
     }
 
     void renderHUD() {
+        PROFILE_ZONE("renderHUD");
         SDL_Color white = { 255, 255, 255, 255 };
 
-        // ʾֵɱʱ
-        renderText("Lives: " + std::to_string(player->lives), 10, 10, white);
-        renderText("Kills: " + std::to_string(enemyKillCount), 10, 40, white);
-        Uint32 elapsedTime = (SDL_GetTicks() - gameStartTime) / 1000;
-        renderText("Time: " + std::to_string(elapsedTime) + "s", 10, 70, white);
+        // 显示生命值、杀敌数和时间，三行文字合并为一次几何提交
+        char line[32];
+        SDL_snprintf(line, sizeof(line), "Lives: %d", sim.player.lives);
+        hudAtlas.addText(line, 10, 10, white);
+        SDL_snprintf(line, sizeof(line), "Kills: %d", sim.enemyKillCount);
+        hudAtlas.addText(line, 10, 40, white);
+        Uint32 elapsedTime = sim.simTime() / 1000;
+        SDL_snprintf(line, sizeof(line), "Time: %us", elapsedTime);
+        hudAtlas.addText(line, 10, 70, white);
+        if (showStats) {
+            SDL_snprintf(line, sizeof(line), "Draw calls: %d", lastDrawCalls);
+            hudAtlas.addText(line, 10, 100, white);
+            // 逐帧分配器的单帧峰值和向系统申请的次数，稳态时次数不再增加
+            const FrameArena& arena = FrameArena::current();
+            SDL_snprintf(line, sizeof(line), "Arena: %uKB, %u mallocs", static_cast<unsigned>(arena.peak() / 1024), static_cast<unsigned>(arena.systemAllocations()));
+            hudAtlas.addText(line, 10, 130, white);
+            // 稳态时每帧应当没有堆分配
+            SDL_snprintf(line, sizeof(line), "Allocs: %u, %u bytes", static_cast<unsigned>(lastFrameAllocations.count), static_cast<unsigned>(lastFrameAllocations.bytes));
+            hudAtlas.addText(line, 10, 160, white);
+        }
+#if STG_PROFILING
+        if (showProfiler) {
+            renderProfiler(showStats ? 200 : 110);
+        }
+#endif
+        hudAtlas.flush(renderer);
+        drawCalls++;
+    }
+
+#if STG_PROFILING
+    // 导出最近 TRACE_SECONDS 秒的时间线，文件名带上时刻和原因
+    void captureTrace(const char* reason) {
+        char path[64];
+        SDL_snprintf(path, sizeof(path), "trace_%u_%s.json", SDL_GetTicks(), reason);
+        traceWriter.capture(path, TRACE_SECONDS);
+    }
+
+    // 游戏中某一帧超出预算时自动导出时间线
+    void checkFrameBudget(double frameSeconds) {
+        Uint32 now = SDL_GetTicks();
+        if (gameState == PLAYING && frameSeconds > FRAME_BUDGET_SECONDS && now - lastTraceTime > TRACE_COOLDOWN) {
+            lastTraceTime = now;
+            captureTrace("slow");
+        }
+    }
+
+    // 每个分析区间最近若干帧的平均耗时、最长耗时和平均堆分配次数，子区间缩进显示
+    void renderProfiler(int y) {
+        SDL_Color yellow = { 255, 255, 0, 255 };
+        char line[80];
+        SDL_snprintf(line, sizeof(line), "%-28s %7s %7s %7s", "Zone", "avg ms", "max ms", "allocs");
+        hudAtlas.addText(line, 10, y, yellow);
+        const Profiler& profiler = Profiler::instance();
+        for (int index : profiler.displayOrder()) {
+            const ZoneStats& zone = profiler.zones[index];
+            y += 26;
+            if (y > SCREEN_HEIGHT - 26) {
+                break;
+            }
+            SDL_snprintf(line, sizeof(line), "%*s%-*s %7.3f %7.3f %7.1f", zone.depth * 2, "", 28 - zone.depth * 2, zone.name, zone.averageMs, zone.worstMs, zone.averageAllocations);
+            hudAtlas.addText(line, 10, y, yellow);
+        }
+    }
+#endif
+
+    void renderBullets(Fixed alpha) {
+        // bulletSprites[0] 为敌人子弹，[1] 为玩家子弹
+        const BulletPool* pools[2] = { &sim.enemyBullets, &sim.playerBullets };
+        for (int faction = 0; faction < 2; ++faction) {
+            const BulletPool& bullets = *pools[faction];
+            const SDL_Rect& sprite = spriteAtlas.sprites[bulletSprites[faction]];
+            for (int i = 0; i < bullets.count; ++i) {
+                Rect r = interpolateRect(bullets.prevX[i], bullets.prevY[i], bullets.x[i], bullets.y[i], BulletPool::BULLET_W, BulletPool::BULLET_H, alpha);
+                spriteBatch.add(sprite, SDL_Rect{ r.x, r.y, r.w, r.h });
+            }
+        }
+    }
+
+    void renderEnemies(Fixed alpha) {
+        const std::vector<Transform>& transforms = sim.enemies.column<Transform>();
+        const std::vector<Hitbox>& hitboxes = sim.enemies.column<Hitbox>();
+        const std::vector<Sprite>& sprites = sim.enemies.column<Sprite>();
+        for (int e = 0; e < sim.enemies.size(); ++e) {
+            const SDL_Rect& sprite = spriteAtlas.sprites[kindSprites[sprites[e].kind]];
+            spriteBatch.add(sprite, lerpRect(transforms[e], hitboxes[e], alpha));
+        }
     }
 
-    void render() {
+    void render(float alpha = 1.0f) {
         if (gameState == GAME_OVER) {
             renderGameOver();
         }
@@ -348,30 +390,37 @@ public:
             renderMainMenu();
         }
         else {
+            PROFILE_ZONE("render");
+            drawCalls = 0;
             SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
             SDL_RenderClear(renderer);
 
-            player->render(renderer);
-            for (auto& bullet : bullets) {
-                bullet.render(renderer);
-            }
-            for (auto& enemy : enemies) {
-                enemy.render(renderer);
-            }
+            // 所有实体都来自同一张图集，合并为一次几何提交；插值比例转为定点数后全程整数运算
+            Fixed blend = static_cast<Fixed>(alpha * FIXED_ONE);
+            spriteBatch.begin(spriteAtlas.texture, spriteAtlas.width, spriteAtlas.height);
+            spriteBatch.add(spriteAtlas.sprites[kindSprites[SPRITE_PLAYER]], lerpRect(sim.player.transform, sim.player.hitbox, blend));
+            renderBullets(blend);
+            renderEnemies(blend);
+            drawCalls += spriteBatch.flush(renderer);
 
             renderHUD();
 
+            PROFILE_ZONE("present");
+            Uint64 presentStart = SDL_GetPerformanceCounter();
             SDL_RenderPresent(renderer);
+            presentTicks = SDL_GetPerformanceCounter() - presentStart;
+            lastDrawCalls = drawCalls;
         }
     }
 
     void close() {
-        SDL_DestroyTexture(playerTexture);
-        SDL_DestroyTexture(enemyTexture);
-        TTF_CloseFont(font);
+#if STG_PROFILING
+        traceWriter.flush(); // 退出前写完仍在排队的时间线
+#endif
+        spriteAtlas.destroy();
+        hudAtlas.destroy();
+        textCache.clear(); // 字体由缓存持有
 
-        playerTexture = nullptr;
-        enemyTexture = nullptr;
         font = nullptr;
 
         SDL_DestroyRenderer(renderer);
@@ -384,104 +433,105 @@ public:
     }
 
     void resetGame() {
-        player = new Player(400, 500, 50, 50, playerTexture, 3);
-        enemies.clear();
-        bullets.clear();
-        score = 0;
-        enemySpawnRate = 3000;
-        lastEnemySpawnTime = 0;
-        lastEnemyFireTime = 0;
-        enemyKillCount = 0;
-        gameStartTime = SDL_GetTicks();
-        finalGameTime = 0;
-    }
-
-    void update() {
-        if (gameState == GAME_OVER) {
+        frameStats.clear();
+        if (replaying) {
+            sim.reset(replayPlayer.seed); // 回放时使用录像中的种子
+            replayPlayer.rewind();
             return;
         }
+        sim.reset(SDL_GetPerformanceCounter()); // 每局使用不同的种子
+        if (!recordPath.empty()) {
+            recorder.begin(sim.seed);
+        }
+    }
 
-        // ӵλ
-        for (auto bulletIt = bullets.begin(); bulletIt != bullets.end();) {
-            bulletIt->update();
-            if (bulletIt->rect.y < 0 || bulletIt->rect.y > SCREEN_HEIGHT) {
-                bulletIt = bullets.erase(bulletIt);  // ƳĻӵ
-            }
-            else {
-                ++bulletIt;
-            }
+    // 保存当前录像，对局结束或中途退出时调用
+    void saveRecording() {
+        if (!recordPath.empty() && recorder.ticks > 0) {
+            recordedSessions++;
+            recorder.save(sessionRecordPath(recordPath, recordedSessions), TICK_RATE, sim.stateHash());
+            recorder.begin(sim.seed);
         }
+    }
 
-        // µλ
-        for (auto& enemy : enemies) {
-            enemy.update();
+    // 推进一个逻辑帧，currentKeyStates 为本帧的键盘状态（按扫描码索引）
+    void update(const Uint8* currentKeyStates) {
+        if (gameState == GAME_OVER) {
+            return;
+        }
+        PROFILE_ZONE("update");
+        stress.apply(sim);
 
-            // ӵ
-            Uint32 currentTime = SDL_GetTicks();
-            if (currentTime - enemy.lastShotTime > enemy.shootInterval) {
-                enemy.fireBullet(bullets);
-                enemy.lastShotTime = currentTime;
+        Input input = inputFromKeys(currentKeyStates);
+        if (replaying) {
+            // 录像播放完毕，在当前状态结束这一局
+            if (!replayPlayer.next(input)) {
+                sim.finalGameTime = sim.simTime() / 1000;
+                finishGame();
+                return;
             }
         }
+        else if (!recordPath.empty()) {
+            recorder.record(input);
+        }
 
-        // ӵ˵ײ
-        checkBulletEnemyCollision();
-
-        // ˵ײ
-        checkPlayerEnemyCollision();
+        sim.step(input, 1.0 / TICK_RATE);
+        FrameArena::current().reset(); // 本帧的临时数据到此全部失效
 
-        // ӵҵײ
-        checkBulletPlayerCollision();
+        // 模拟结束后进入游戏结束状态
+        if (sim.gameOver) {
+            finishGame();
+        }
+    }
 
-        // Ƿ񵽴Ļײ
-        checkEnemyBottomCollision();
+    // 记录一帧的更新和渲染耗时（计数器单位），渲染耗时包含提交
+    void recordFrame(Uint64 updateTicks, Uint64 renderTicks) {
+        if (gameState != PLAYING) {
+            return;
+        }
+        Uint64 frequency = SDL_GetPerformanceFrequency();
+        frameStats.update.record(updateTicks * 1000000 / frequency);
+        frameStats.render.record((renderTicks - presentTicks) * 1000000 / frequency);
+        frameStats.present.record(presentTicks * 1000000 / frequency);
+    }
 
-        // µĵ
-        spawnEnemy();
+    // 把本局的帧时间统计追加到统计文件，附带构建信息便于比较不同机器和版本
+    void writeFrameStats() {
+        char title[160];
+        SDL_snprintf(title, sizeof(title), "Session seed %llu, score %d, time %us, build %s %s %s",
+            static_cast<unsigned long long>(sim.seed), sim.score, sim.finalGameTime, BUILD_CONFIG, __DATE__, __TIME__);
+        frameStats.append(FRAME_STATS_PATH, title);
+    }
 
-        // ֵΪ0Ϸ״̬
-        if (player->lives <= 0) {
-            gameState = GAME_OVER;
-            finalGameTime = (SDL_GetTicks() - gameStartTime) / 1000;  // ¼Ϸʱ䣨룩
+    void finishGame() {
+        gameState = GAME_OVER;
+        writeFrameStats();
+        if (replaying && sim.stateHash() != replayPlayer.finalHash) {
+            std::cerr << "Replay desynchronized at tick " << sim.tick << "!" << std::endl;
         }
+        saveRecording();
     }
 
     void handleMouseClick(int x, int y, bool& quit) {
         if (gameState == MAIN_MENU) {
-            // Ƿ "Start Game" ť
+            // 检查是否点击了 "Start Game" 按钮
             if (x >= startButtonRect.x && x <= startButtonRect.x + startButtonRect.w &&
                 y >= startButtonRect.y && y <= startButtonRect.y + startButtonRect.h) {
-                gameState = PLAYING;           // лϷ״̬
-                gameStartTime = SDL_GetTicks(); // ¼Ϸʼʱ
-                resetGame();                    // Ϸ
+                gameState = PLAYING;           // 切换到游戏进行状态
+                resetGame();                    // 重置游戏数据和模拟时间
             }
-            // Ƿ "Quit Game" ť
+            // 检查是否点击了 "Quit Game" 按钮
             else if (x >= quitButtonRect.x && x <= quitButtonRect.x + quitButtonRect.w &&
                 y >= quitButtonRect.y && y <= quitButtonRect.y + quitButtonRect.h) {
-                quit = true; // ˳Ϸ
+                quit = true; // 退出游戏
             }
         }
         else if (gameState == GAME_OVER) {
-            // Ƿ "Return to Main Menu" ť
+            // 检查是否点击了 "Return to Main Menu" 按钮
             if (x >= returnButtonRect.x && x <= returnButtonRect.x + returnButtonRect.w &&
                 y >= returnButtonRect.y && y <= returnButtonRect.y + returnButtonRect.h) {
-                gameState = MAIN_MENU; // ص˵
-                resetGame();           // Ϸ
-            }
-        }
-    }
-
-
-    void spawnEnemy() {
-        Uint32 currentTime = SDL_GetTicks();
-        if (currentTime - lastEnemySpawnTime > static_cast<Uint32>(enemySpawnRate)) {
-            int x = rand() % (SCREEN_WIDTH - 50); // ɵ˵ x 
-            enemies.emplace_back(x, 0, 50, 50, enemyTexture); // ڶµĵ
-            lastEnemySpawnTime = currentTime; // һɵ˵ʱ
-
-            // ʱƣ𽥼ٵɼӿٶ
-            if (enemySpawnRate > minSpawnRate) {
-                enemySpawnRate -= 100;
+                gameState = MAIN_MENU; // 返回到主菜单
+                resetGame();           // 重置游戏数据
             }
         }
     }
@@ -498,129 +548,323 @@ public:
                 SDL_GetMouseState(&x, &y);
                 handleMouseClick(x, y, quit);
             }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3 && !e.key.repeat) {
+                showStats = !showStats; // 显示/隐藏渲染统计
+            }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F4 && !e.key.repeat) {
+                showProfiler = !showProfiler; // 显示/隐藏性能分析
+            }
+#if STG_PROFILING
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F5 && !e.key.repeat) {
+                captureTrace("manual"); // 导出时间线
+            }
+#endif
         }
+    }
+};
+
+// 脚本输入：始终开火，水平方向追踪最靠下的敌人
+Input scriptedInput(const Simulation& sim) {
+    Input input = { INPUT_FIRE };
 
-        if (gameState == PLAYING) {
-            const Uint8* currentKeyStates = SDL_GetKeyboardState(nullptr);
-            player->handleInput(currentKeyStates, bullets);
+    int target = -1;
+    for (int e = 0; e < sim.enemies.size(); ++e) {
+        if (target < 0 || sim.enemyRect(e).y > sim.enemyRect(target).y) {
+            target = e;
         }
     }
+    if (target >= 0) {
+        Rect targetRect = sim.enemyRect(target);
+        Rect playerRect = sim.playerRect();
+        int playerCenter = playerRect.x + playerRect.w / 2;
+        int targetCenter = targetRect.x + targetRect.w / 2;
+        if (targetCenter < playerCenter - 5) input.buttons |= INPUT_LEFT;
+        if (targetCenter > playerCenter + 5) input.buttons |= INPUT_RIGHT;
+    }
+    return input;
+}
 
-    void checkBulletEnemyCollision() {
-        for (auto bulletIt = bullets.begin(); bulletIt != bullets.end();) {
-            bool bulletRemoved = false;
-            for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-                if (bulletIt->isPlayerBullet && SDL_HasIntersection(&bulletIt->rect, &enemyIt->rect)) {
-                    bulletIt = bullets.erase(bulletIt);  // Ƴӵ
-                    enemyIt = enemies.erase(enemyIt);    // Ƴ
-                    score += 100;                       // ӷ
-                    enemyKillCount++;                   // »ɱ
-                    player->increaseKillCount();        // ǷҪӶⵯĻ
-                    bulletRemoved = true;
-                    break;
-                }
-                else {
-                    ++enemyIt;
-                }
-            }
-            if (!bulletRemoved) {
-                ++bulletIt;
-            }
-        }
+// 无窗口模式：不创建窗口、渲染器、字体和纹理，以最快速度连续模拟多局游戏
+// 第 i 局的种子为 baseSeed + i，同样的参数总是得到同样的结果
+int runHeadless(int sessions, int maxTicks, Uint64 baseSeed) {
+    Simulation sim;
+    Uint64 totalTicks = 0;
+    Uint64 totalScore = 0;
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (int session = 0; session < sessions; ++session) {
+        sim.reset(baseSeed + session);
+        int tick = 0;
+        while (!sim.gameOver && tick < maxTicks) {
+            sim.step(scriptedInput(sim), 1.0 / TICK_RATE);
+            FrameArena::current().reset();
+            tick++;
+        }
+        totalTicks += tick;
+        totalScore += sim.score;
     }
 
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+    std::cout << "Sessions: " << sessions << std::endl;
+    std::cout << "Ticks: " << totalTicks << std::endl;
+    std::cout << "Average score: " << (sessions > 0 ? totalScore / sessions : 0) << std::endl;
+    std::cout << "Wall time: " << seconds << "s" << std::endl;
+    if (seconds > 0.0) {
+        std::cout << "Sessions per minute: " << sessions * 60.0 / seconds << std::endl;
+        std::cout << "Ticks per second: " << totalTicks / seconds << std::endl;
+    }
+    const FrameArena& arena = FrameArena::current();
+    std::cout << "Frame arena: peak " << arena.peak() << " bytes, " << arena.systemAllocations() << " system allocations" << std::endl;
+    return 0;
+}
 
+// 以最快速度回放录像并校验结束时的状态哈希
+int runReplay(const ReplayPlayer& replay) {
+    Simulation sim;
+    sim.reset(replay.seed);
+    Uint64 startCounter = SDL_GetPerformanceCounter();
 
-    void checkPlayerEnemyCollision() {
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            if (SDL_HasIntersection(&player->rect, &enemyIt->rect)) {
-                enemyIt = enemies.erase(enemyIt);  // Ƴ
-                player->lives--;                  // ֵ
-                if (player->lives <= 0) {
-                    gameState = GAME_OVER;        // лϷ״̬
-                }
-            }
-            else {
-                ++enemyIt;
-            }
+    for (const auto& run : replay.runs) {
+        Input input = { run.buttons };
+        for (uint32_t i = 0; i < run.count; ++i) {
+            sim.step(input, 1.0 / TICK_RATE);
+            FrameArena::current().reset();
         }
     }
 
-    void checkBulletPlayerCollision() {
-        for (auto bulletIt = bullets.begin(); bulletIt != bullets.end();) {
-            if (!bulletIt->isPlayerBullet && SDL_HasIntersection(&bulletIt->rect, &player->rect)) {
-                bulletIt = bullets.erase(bulletIt);  // Ƴӵ
-                player->lives--;                    // ֵ
-                if (player->lives <= 0) {
-                    gameState = GAME_OVER;          // лϷ״̬
-                }
-            }
-            else {
-                ++bulletIt;
-            }
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+    bool match = sim.stateHash() == replay.finalHash;
+    std::cout << "Ticks: " << sim.tick << std::endl;
+    std::cout << "Score: " << sim.score << std::endl;
+    std::cout << "Wall time: " << seconds << "s" << std::endl;
+    std::cout << "State hash: " << (match ? "match" : "MISMATCH") << std::endl;
+    return match ? 0 : 1;
+}
+
+// SDL 及其扩展库通过 SDL_malloc 分配的内存也计入堆分配统计
+SDL_malloc_func sdlMalloc;
+SDL_calloc_func sdlCalloc;
+SDL_realloc_func sdlRealloc;
+SDL_free_func sdlFree;
+
+void* SDLCALL countedMalloc(size_t size) {
+    recordAllocation(size);
+    return sdlMalloc(size);
+}
+
+void* SDLCALL countedCalloc(size_t count, size_t size) {
+    recordAllocation(count * size);
+    return sdlCalloc(count, size);
+}
+
+void* SDLCALL countedRealloc(void* memory, size_t size) {
+    recordAllocation(size);
+    return sdlRealloc(memory, size);
+}
+
+void countSdlAllocations() {
+    SDL_GetOriginalMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+    SDL_SetMemoryFunctions(countedMalloc, countedCalloc, countedRealloc, sdlFree);
+}
+
+int main(int argc, char* args[]) {
+    // 命令行参数：--headless [--sessions N] [--ticks N] [--seed N]
+    //             --record <文件>  录制本次游戏的每一局
+    //             --replay <文件>  回放录像，和 --headless 一起使用时以最快速度回放
+    //             --stress [--enemies N,N,...] [--fire-interval 毫秒] [--spread N] [--bullet-speed 像素每秒] [--step-seconds 秒]
+    //             --scenario <文件>  从场景文件读取压力测试的密度等级
+#if STG_ALLOC_TRACKING
+    countSdlAllocations(); // 必须在 SDL 分配任何内存之前设置
+#endif
+
+    bool headless = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool stressMode = false;
+    const char* scenarioPath = nullptr;
+    const char* stressEnemies = "50,100,200,400,800,1600,3200";
+    StressStep stressStep = { 0, 500, 5, 240, 10.0 };
+    int sessions = 100;
+    int maxTicks = TICK_RATE * 60 * 3; // 每局最多模拟 3 分钟
+    Uint64 seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(args[i], "--headless") == 0) {
+            headless = true;
+        }
+        else if (std::strcmp(args[i], "--sessions") == 0 && i + 1 < argc) {
+            sessions = std::atoi(args[++i]);
+        }
+        else if (std::strcmp(args[i], "--ticks") == 0 && i + 1 < argc) {
+            maxTicks = std::atoi(args[++i]);
+        }
+        else if (std::strcmp(args[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(args[++i], nullptr, 10);
+        }
+        else if (std::strcmp(args[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = args[++i];
+        }
+        else if (std::strcmp(args[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = args[++i];
+        }
+        else if (std::strcmp(args[i], "--stress") == 0) {
+            stressMode = true;
+        }
+        else if (std::strcmp(args[i], "--scenario") == 0 && i + 1 < argc) {
+            stressMode = true;
+            scenarioPath = args[++i];
+        }
+        else if (std::strcmp(args[i], "--enemies") == 0 && i + 1 < argc) {
+            stressEnemies = args[++i];
+        }
+        else if (std::strcmp(args[i], "--fire-interval") == 0 && i + 1 < argc) {
+            stressStep.fireInterval = (std::max)(std::atoi(args[++i]), 1);
+        }
+        else if (std::strcmp(args[i], "--spread") == 0 && i + 1 < argc) {
+            stressStep.spread = (std::max)(std::atoi(args[++i]), 1);
+        }
+        else if (std::strcmp(args[i], "--bullet-speed") == 0 && i + 1 < argc) {
+            stressStep.bulletSpeed = (std::max)(std::atoi(args[++i]), 1); // 速度为 0 的子弹永远不会出屏
+        }
+        else if (std::strcmp(args[i], "--step-seconds") == 0 && i + 1 < argc) {
+            stressStep.seconds = std::atof(args[++i]);
         }
     }
 
-    void checkEnemyBottomCollision() {
-        for (auto enemyIt = enemies.begin(); enemyIt != enemies.end();) {
-            if (enemyIt->rect.y + enemyIt->rect.h >= SCREEN_HEIGHT) {
-                enemyIt = enemies.erase(enemyIt);  // Ƴ
-                player->lives--;                  // ۳ֵ
-                if (player->lives <= 0) {
-                    gameState = GAME_OVER;        // лϷ״̬
-                }
-            }
-            else {
-                ++enemyIt;
+    // 压力测试的密度等级：场景文件优先，否则每个敌人数量对应一级
+    std::vector<StressStep> stressSteps;
+    if (scenarioPath != nullptr) {
+        if (!loadStressScenario(scenarioPath, stressSteps)) {
+            return -1;
+        }
+    }
+    else if (stressMode) {
+        for (const char* p = stressEnemies; *p != '\0';) {
+            char* end;
+            stressStep.enemies = static_cast<int>(std::strtol(p, &end, 10));
+            if (end == p) {
+                break;
             }
+            stressSteps.push_back(stressStep);
+            p = (*end == ',') ? end + 1 : end;
         }
     }
 
-};
+    ReplayPlayer replay;
+    if (replayPath != nullptr) {
+        if (!replay.load(replayPath)) {
+            return -1;
+        }
+        if (replay.tickRate != TICK_RATE) {
+            std::cerr << "Replay was recorded at " << replay.tickRate << " ticks per second, expected " << TICK_RATE << "!" << std::endl;
+            return -1;
+        }
+    }
 
-int main(int argc, char* args[]) {
+    if (headless) {
+        if (replayPath != nullptr) {
+            return runReplay(replay);
+        }
+        return runHeadless(sessions, maxTicks, seed);
+    }
 
-    HWND hwnd = GetConsoleWindow();
-    ShowWindow(hwnd, SW_HIDE);
+#ifdef _WIN32
+    // 压力测试的结果输出到控制台，此时保留控制台窗口
+    if (!stressMode) {
+        HWND hwnd = GetConsoleWindow();
+        ShowWindow(hwnd, SW_HIDE);
+    }
+#endif
 
     Game game;
 
-    // ʼϷ
+    // 初始化游戏
     if (!game.init()) {
         std::cerr << "Failed to initialize!" << std::endl;
         SDL_Log("Program started");
         return -1;
     }
 
-    // Դ
-    game.playerTexture = game.loadTexture("player.png");
-    game.enemyTexture = game.loadTexture("enemy.png");
-
-    if (game.playerTexture == nullptr || game.enemyTexture == nullptr) {
+    // 加载资源
+    if (!game.loadTextures()) {
         std::cerr << "Failed to load textures!" << std::endl;
         game.close();
         return -1;
     }
 
-    // ʼҺϷ
-    game.player = new Player(375, 500, 50, 50, game.playerTexture, 3);
-    game.enemies.clear();
-    game.bullets.clear();
+    if (replayPath != nullptr) {
+        // 回放模式直接进入游戏，按正常速度播放
+        game.replayPlayer = replay;
+        game.replaying = true;
+        game.gameState = PLAYING;
+        game.resetGame();
+    }
+    else if (stressMode) {
+        // 压力测试直接进入游戏，玩家无敌，敌人子弹池扩容以免密度受容量限制
+        game.stress.steps = stressSteps;
+        game.sim.enemyBullets = BulletPool(STRESS_MAX_BULLETS);
+        int maxEnemies = ENEMY_CAPACITY;
+        for (const StressStep& step : stressSteps) {
+            maxEnemies = (std::max)(maxEnemies, step.enemies);
+        }
+        game.sim.enemies.reserve(maxEnemies);
+        game.reserveSprites(maxEnemies);
+        game.gameState = PLAYING;
+        game.resetGame();
+    }
+    else if (recordPath != nullptr) {
+        game.recordPath = recordPath;
+    }
+
+    // 主循环：逻辑以固定步长推进，渲染按显示器刷新率进行并在两帧之间插值
+    const double tickSeconds = 1.0 / TICK_RATE;
+    const double maxFrameSeconds = 0.25; // 卡顿时最多追赶的时间，避免越追越慢
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+    double accumulator = 0.0;
 
-    // ѭ
     bool quit = false;
     while (!quit) {
-        game.handleEvents(quit);
+        AllocationCount frameAllocations = threadAllocations();
+        Uint64 currentCounter = SDL_GetPerformanceCounter();
+        double frameSeconds = static_cast<double>(currentCounter - lastCounter) / counterFrequency;
+        double rawFrameSeconds = frameSeconds; // 未截断的帧时间，用于统计
+        lastCounter = currentCounter;
+        if (frameSeconds > maxFrameSeconds) {
+            frameSeconds = maxFrameSeconds;
+        }
+
+        {
+            PROFILE_ZONE("handleEvents");
+            game.handleEvents(quit);
+        }
 
         switch (game.gameState) {
         case MAIN_MENU:
+            accumulator = 0.0;
             game.renderMainMenu();
             break;
 
         case PLAYING:
-            game.update();
-            game.render();
+        {
+            accumulator += frameSeconds;
+            Uint64 updateStart = SDL_GetPerformanceCounter();
+            while (accumulator >= tickSeconds && game.gameState == PLAYING) {
+                game.update(SDL_GetKeyboardState(nullptr)); // 每个逻辑帧读取一次键盘状态
+                accumulator -= tickSeconds;
+            }
+            Uint64 renderStart = SDL_GetPerformanceCounter();
+            game.render(static_cast<float>(accumulator / tickSeconds));
+            game.recordFrame(renderStart - updateStart, SDL_GetPerformanceCounter() - renderStart);
+
+            // 压力测试的所有等级完成后退出
+            if (game.stress.active()) {
+                game.stress.frame(rawFrameSeconds, game.sim.playerBullets.count + game.sim.enemyBullets.count, std::cout);
+                if (!game.stress.active()) {
+                    quit = true;
+                }
+            }
             break;
+        }
 
         case GAME_OVER:
             game.renderGameOver();
@@ -630,10 +874,27 @@ int main(int argc, char* args[]) {
             break;
         }
 
-        SDL_Delay(game.frameDelay);
+        game.lastFrameAllocations = threadAllocations() - frameAllocations;
+        PROFILE_FRAME();
+#if STG_PROFILING
+        game.checkFrameBudget(static_cast<double>(SDL_GetPerformanceCounter() - currentCounter) / counterFrequency);
+#endif
+
+        // 没有垂直同步时睡眠到一个逻辑帧的间隔，避免菜单和结束画面占满一个核心；压力测试不限帧率
+        if (!game.vsync && !game.stress.active()) {
+            double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - currentCounter) / counterFrequency;
+            if (elapsed < tickSeconds) {
+                SDL_Delay(static_cast<Uint32>((tickSeconds - elapsed) * 1000.0));
+            }
+        }
+    }
+
+    // 中途退出时也保存已录制的部分
+    if (game.gameState == PLAYING) {
+        game.saveRecording();
     }
 
-    // ͷԴرϷ
+    // 释放资源并关闭游戏
     game.close();
     return 0;
 }